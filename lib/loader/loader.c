@@ -10,6 +10,11 @@
 #include "loader/loader.h"
 #include "error/assertion.h"
 #include "log/log.h"
+#include <string.h>
+
+#if USE_LOADER_VFS
+#include "os/alloc/alloc.h"
+#endif
 
 /* Defines ================================================================== */
 #define LOG_TAG loader
@@ -48,10 +53,56 @@ error_t module_load(module_t * module, uint8_t * data) {
   ASSERT_RETURN(module && data, E_NULL);
 
   module->type = get_file_type(data);
+  module->image = NULL;
 
   MODULE_RUN_FOR_FILETYPE(module, load, data);
 }
 
+#if USE_LOADER_VFS
+error_t module_load_file(module_t * module, vfs_file_t * file) {
+  ASSERT_RETURN(module && file, E_NULL);
+
+  const uint8_t * data = NULL;
+  size_t size = 0;
+
+  ERROR_CHECK_RETURN(vfs_map(file, &data, &size));
+  ASSERT_RETURN(size, E_EMPTY);
+
+  // Mapped memory may be read-only and must stay intact for the next load,
+  // so relocations are applied to a private copy
+  uint8_t * image = os_alloc(size);
+  ASSERT_RETURN(image, E_NOMEM);
+
+  memcpy(image, data, size);
+
+  error_t err = module_load(module, image);
+
+  if (err != E_OK) {
+    os_free(image);
+    return err;
+  }
+
+  module->image = image;
+
+  return E_OK;
+}
+#endif
+
+error_t module_unload(module_t * module) {
+  ASSERT_RETURN(module, E_NULL);
+
+#if USE_LOADER_VFS
+  if (module->image) {
+    os_free(module->image);
+    module->image = NULL;
+  }
+#endif
+
+  module->type = EXE_TYPE_NONE;
+
+  return E_OK;
+}
+
 error_t module_get_symbol(module_t * module, void ** symbol, const char * name) {
   ASSERT_RETURN(module && symbol && name, E_NULL);
 
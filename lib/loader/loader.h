@@ -21,6 +21,20 @@ extern "C" {
 #include "elf/elf.h"
 
 /* Defines ================================================================== */
+/**
+ * Enables module_load_file, which loads module from VFS file
+ *
+ * Module image is copied out of the mapped file into os_alloc memory,
+ * so this pulls in both VFS and os_alloc
+ */
+#ifndef USE_LOADER_VFS
+#define USE_LOADER_VFS 0
+#endif
+
+#if USE_LOADER_VFS
+#include "vfs/vfs.h"
+#endif
+
 /**
  * Internal macro
  * Defines exported api type (for iterators, section start/end markers, etc)
@@ -94,6 +108,8 @@ typedef struct {
   union {
     elf_t elf;
   };
+
+  uint8_t * image;  /** Copy made by module_load_file, NULL after module_load */
 } module_t;
 
 /* Variables ================================================================ */
@@ -111,6 +127,31 @@ typedef struct {
  */
 error_t module_load(module_t * module, uint8_t * data);
 
+#if USE_LOADER_VFS
+/**
+ * Loads module from opened file
+ *
+ * Relocations are written into the image, so file contents are copied
+ * (straight from vfs_map, without intermediate read buffer) into memory
+ * allocated with os_alloc. File itself is never modified and can be
+ * closed right after the call. Copy is freed by module_unload
+ *
+ * @note Whole image is copied, not only written sections - module code
+ *       reaches its GOT PC-relatively, so GOT must stay next to the code
+ *
+ * @param module Module context
+ * @param file Opened executable file
+ */
+error_t module_load_file(module_t * module, vfs_file_t * file);
+#endif
+
+/**
+ * Unloads module, freeing image copy made by module_load_file
+ *
+ * @param module Module context
+ */
+error_t module_unload(module_t * module);
+
 /**
  * Retrieves symbol from loaded module
  *
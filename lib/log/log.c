@@ -25,6 +25,83 @@
 static vfs_file_t * log_file;
 
 /* Private functions ======================================================== */
+/**
+ * Converts (v)snprintf result to size of what was actually written
+ */
+__STATIC_INLINE size_t log_clamp_size(int size, size_t buffer_size) {
+  return size < 0 ? 0 : UTIL_MIN((size_t) size, buffer_size - 1);
+}
+
+/**
+ * Formats line header (level and tag) into buffer
+ *
+ * @retval Size of the header, without null-terminator
+ */
+__STATIC_INLINE size_t log_fmt_header(char * buf, size_t buf_size, log_level_t level, const char * tag) {
+  int size = 0;
+
+  if (tag) {
+    size = snprintf(buf, buf_size, "\r[%s%s%s][%s%s%s] ",
+                    log_get_level_color(level),
+                    log_get_level_string(level),
+                    USE_COLOR_LOG ? ANSI_TEXT_RESET : "",
+                    USE_COLOR_LOG ? ANSI_COLOR_FG_MAGENTA : "",
+                    tag,
+                    USE_COLOR_LOG ? ANSI_TEXT_RESET : "");
+  } else {
+    size = snprintf(buf, buf_size, "\r[%s%s%s] ",
+                    log_get_level_color(level),
+                    log_get_level_string(level),
+                    USE_COLOR_LOG ? ANSI_TEXT_RESET : "");
+  }
+
+  return log_clamp_size(size, buf_size);
+}
+
+/**
+ * Checks whether log file is a block device, that takes vectored writes
+ */
+__STATIC_INLINE bool log_file_has_writev(void) {
+  vfs_node_t * node = vfs_get_file_node(log_file);
+
+  return node && node->head.type == VFS_BLOCK && node->block.data.writev;
+}
+
+/**
+ * Formats whole line into single buffer and writes it with one call
+ *
+ * Kept out of line, so vlog_fmt stack holds only one of the line buffers
+ */
+static __NO_INLINE void log_write_line(log_level_t level, const char * tag, const char * fmt, va_list args) {
+  char buf[LOG_LINE_SIZE];
+  size_t size = log_fmt_header(buf, sizeof(buf), level, tag);
+
+  size += log_clamp_size(vsnprintf(buf + size, sizeof(buf) - size, fmt, args), sizeof(buf) - size);
+  size += log_clamp_size(snprintf(buf + size, sizeof(buf) - size, LINE_ENDING), sizeof(buf) - size);
+
+  log_write_buffer((const uint8_t *) buf, size);
+}
+
+/**
+ * Writes header, message and line ending to the driver as one vector,
+ * without copying them together
+ */
+static __NO_INLINE void log_write_vector(log_level_t level, const char * tag, const char * fmt, va_list args) {
+  char header[LOG_HEADER_SIZE];
+  char message[LOG_LINE_SIZE];
+
+  size_t header_size = log_fmt_header(header, sizeof(header), level, tag);
+  int message_size = vsnprintf(message, sizeof(message), fmt, args);
+
+  vfs_iovec_t iov[] = {
+    {header,               header_size},
+    {message,              log_clamp_size(message_size, sizeof(message))},
+    {(void *) LINE_ENDING, sizeof(LINE_ENDING) - 1},
+  };
+
+  vfs_writev(log_file, iov, UTIL_ARR_SIZE(iov));
+}
+
 /* Shared functions ========================================================= */
 error_t log_init(vfs_file_t * out) {
   log_file = out;
@@ -77,30 +154,11 @@ __WEAK void vlog_fmt(
   const char * fmt,
   va_list args
 ) {
-  char buf[LOG_LINE_SIZE] = {'\r'};
-  size_t size = 1;
-
-  if (tag) {
-    size += snprintf(buf + size, sizeof(buf) - size - 1, "[%s%s%s][%s%s%s] ",
-                     log_get_level_color(level),
-                     log_get_level_string(level),
-                     USE_COLOR_LOG ? ANSI_TEXT_RESET : "",
-                     USE_COLOR_LOG ? ANSI_COLOR_FG_MAGENTA : "",
-                     tag,
-                     USE_COLOR_LOG ? ANSI_TEXT_RESET : "");
+  if (log_file_has_writev()) {
+    log_write_vector(level, tag, fmt, args);
   } else {
-    size += snprintf(buf + size, sizeof(buf) - size - 1, "[%s%s%s] ",
-                     log_get_level_color(level),
-                     log_get_level_string(level),
-                     USE_COLOR_LOG ? ANSI_TEXT_RESET : "");
+    log_write_line(level, tag, fmt, args);
   }
-
-  size += vsnprintf(buf + size, sizeof(buf) - size - 1, fmt, args);
-  size += snprintf(buf + size, sizeof(buf) - size - 1, LINE_ENDING);
-
-  buf[size] = 0;
-
-  log_write_buffer((const uint8_t *) buf, size);
 }
 
 void log_fmt(const char * file, int line, log_level_t level, const char * tag, const char * fmt, ...) {
@@ -28,6 +28,14 @@ extern "C" {
 #define LOG_LINE_SIZE 192
 #endif
 
+/**
+ * Max size of log line header (level and tag), written separately from
+ * the message, when log file driver implements writev
+ */
+#ifndef LOG_HEADER_SIZE
+#define LOG_HEADER_SIZE 48
+#endif
+
 /**
  * Helper macros to check for LOG_TAG presence
  */
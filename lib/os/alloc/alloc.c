@@ -9,35 +9,389 @@
 /* Includes ================================================================= */
 #include "os/alloc/alloc.h"
 #include "error/assertion.h"
+#include "log/log.h"
+#include "os/os.h"
+#include <string.h>
 
 /* Defines ================================================================== */
+#define LOG_TAG alloc
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
+/**
+ * Registered heap
+ */
+typedef struct {
+  os_heap_t * heap;
+  const char * name;
+  uint8_t flags;
+} os_alloc_heap_t;
+
+#if OS_STAT_TRACE_TASK_HEAP
+/**
+ * Prepended to every allocation, attributes it to a task
+ */
+typedef struct {
+  os_task_t * owner;  /** Task that allocated the memory, NULL if none */
+  size_t size;        /** Requested size */
+  os_heap_t * heap;   /** Heap the memory came from */
+  size_t offset;      /** Offset of user pointer from start of allocation */
+} os_alloc_tag_t;
+#endif
+
 /* Variables ================================================================ */
 static os_heap_t * os_heap;
 
+static os_alloc_heap_t os_heaps[OS_ALLOC_HEAP_COUNT];
+static size_t os_heaps_count;
+
+#if USE_OS_ALLOC_SLAB
+static os_slab_t os_slab;
+#endif
+
 /* Private functions ======================================================== */
+/**
+ * Finds registered heap, that contains ptr
+ */
+__STATIC_INLINE os_heap_t * os_alloc_find_heap(void * ptr) {
+  for (size_t i = 0; i < os_heaps_count; ++i) {
+    os_heap_t * heap = os_heaps[i].heap;
+
+    if ((uint8_t *) ptr >= heap->start && (uint8_t *) ptr < heap->start + heap->size) {
+      return heap;
+    }
+  }
+
+  return os_heap;
+}
+
+/**
+ * Allocates from slab (if enabled, heap is default and size fits) or heap
+ */
+__STATIC_INLINE void * os_alloc_raw(os_heap_t * heap, size_t size, size_t align) {
+  if (!heap) {
+    return NULL;
+  }
+
+#if USE_OS_ALLOC_SLAB
+  if (heap == os_heap && align <= sizeof(void *)) {
+    void * ptr = os_slab_alloc(&os_slab, size);
+
+    if (ptr) {
+      return ptr;
+    }
+  }
+#endif
+
+  if (align > sizeof(void *)) {
+    return os_heap_alloc_aligned(heap, size, align);
+  }
+
+  return os_heap_alloc(heap, size);
+}
+
+/**
+ * Returns memory to slab or heap, depending on where it came from
+ */
+__STATIC_INLINE error_t os_free_raw(os_heap_t * heap, void * ptr) {
+#if USE_OS_ALLOC_SLAB
+  if (os_slab_contains(&os_slab, ptr)) {
+    return os_slab_free(&os_slab, ptr);
+  }
+#endif
+
+  return os_heap_free(heap ? heap : os_alloc_find_heap(ptr), ptr);
+}
+
+/**
+ * Resizes slab or heap allocation in place
+ */
+__STATIC_INLINE bool os_alloc_resize_raw(os_heap_t * heap, void * ptr, size_t size) {
+#if USE_OS_ALLOC_SLAB
+  if (os_slab_contains(&os_slab, ptr)) {
+    return size <= os_slab_block_size(&os_slab, ptr);
+  }
+#endif
+
+  return os_heap_resize(heap ? heap : os_alloc_find_heap(ptr), ptr, size) == E_OK;
+}
+
+#if !OS_STAT_TRACE_TASK_HEAP
+/**
+ * Usable size of slab or heap allocation
+ */
+__STATIC_INLINE size_t os_alloc_raw_size(void * ptr) {
+#if USE_OS_ALLOC_SLAB
+  if (os_slab_contains(&os_slab, ptr)) {
+    return os_slab_block_size(&os_slab, ptr);
+  }
+#endif
+
+  return os_heap_block_size(os_alloc_find_heap(ptr), ptr);
+}
+#endif
+
+#if OS_STAT_TRACE_TASK_HEAP
+/**
+ * Allocates tagged block and charges it to owner, quota is not checked
+ */
+__STATIC_INLINE void * os_alloc_tagged(os_heap_t * heap, size_t size, size_t align, os_task_t * owner) {
+  /* Keep user pointer aligned, tag is right before it */
+  size_t offset = sizeof(os_alloc_tag_t);
+
+  if (align > sizeof(void *)) {
+    offset = (offset + align - 1) & ~(align - 1);
+  }
+
+  uint8_t * raw = os_alloc_raw(heap, size + offset, align);
+
+  if (!raw) {
+    return NULL;
+  }
+
+  os_alloc_tag_t * tag = (os_alloc_tag_t *) (raw + offset) - 1;
+
+  tag->owner = owner;
+  tag->size = size;
+  tag->heap = heap;
+  tag->offset = offset;
+
+  if (owner) {
+    owner->heap.used += size;
+
+    if (owner->heap.used > owner->heap.peak) {
+      owner->heap.peak = owner->heap.used;
+    }
+  }
+
+  return raw + offset;
+}
+#endif
+
+/**
+ * Common implementation of os_alloc*
+ */
+__STATIC_INLINE void * os_alloc_impl(os_heap_t * heap, size_t size, size_t align) {
+#if OS_STAT_TRACE_TASK_HEAP
+  os_task_t * task = os_task_current();
+
+  if (task && task->heap.quota && task->heap.used + size > task->heap.quota) {
+    log_warn("os_alloc: task '%s' heap quota exceeded (%u+%u > %u)",
+             task->name, task->heap.used, size, task->heap.quota);
+    return NULL;
+  }
+
+  return os_alloc_tagged(heap, size, align, task);
+#else
+  return os_alloc_raw(heap, size, align);
+#endif
+}
+
+/**
+ * Allocates from first heap, that has all flags
+ */
+__STATIC_INLINE void * os_alloc_match(size_t size, uint8_t flags) {
+  for (size_t i = 0; i < os_heaps_count; ++i) {
+    if ((os_heaps[i].flags & flags) == flags) {
+      void * ptr = os_alloc_impl(os_heaps[i].heap, size, 0);
+
+      if (ptr) {
+        return ptr;
+      }
+    }
+  }
+
+  return NULL;
+}
+
 /* Shared functions ========================================================= */
 error_t os_use_heap(os_heap_t * heap) {
   ASSERT_RETURN(heap, E_NULL);
+
+#if USE_OS_ALLOC_SLAB
+  if (os_heap && os_slab.region) {
+    os_heap_free(os_heap, os_slab.region);
+  }
+
+  memset(&os_slab, 0, sizeof(os_slab));
+
+  void * region = os_heap_alloc(heap, OS_SLAB_REGION_SIZE);
+
+  if (region) {
+    os_slab_init(&os_slab, region);
+  } else {
+    log_warn("os_use_heap: no memory for slab, using heap only");
+  }
+#endif
+
   os_heap = heap;
-  return E_OK;
+
+  for (size_t i = 0; i < os_heaps_count; ++i) {
+    if (os_heaps[i].heap == heap) {
+      return E_OK;
+    }
+  }
+
+  return os_add_heap(heap, "os", OS_HEAP_ANY);
 }
 
 os_heap_t * os_get_heap(void) {
   return os_heap;
 }
 
+error_t os_add_heap(os_heap_t * heap, const char * name, uint8_t flags) {
+  ASSERT_RETURN(heap && name, E_NULL);
+  ASSERT_RETURN(os_heaps_count < OS_ALLOC_HEAP_COUNT, E_NOMEM);
+
+  os_heaps[os_heaps_count].heap = heap;
+  os_heaps[os_heaps_count].name = name;
+  os_heaps[os_heaps_count].flags = flags;
+  os_heaps_count++;
+
+  if (!os_heap) {
+    return os_use_heap(heap);
+  }
+
+  return E_OK;
+}
+
+error_t os_add_heap_region(os_heap_t * heap, const char * name, uint8_t flags, void * start, size_t size) {
+  ERROR_CHECK_RETURN(os_heap_create(heap, start, size));
+  return os_add_heap(heap, name, flags);
+}
+
+os_heap_id_t os_get_heap_id(const char * name) {
+  ASSERT_RETURN(name, OS_HEAP_ID_INVALID);
+
+  for (size_t i = 0; i < os_heaps_count; ++i) {
+    if (!strcmp(os_heaps[i].name, name)) {
+      return (os_heap_id_t) i;
+    }
+  }
+
+  return OS_HEAP_ID_INVALID;
+}
+
+os_heap_t * os_get_heap_by_id(os_heap_id_t id) {
+  return id < os_heaps_count ? os_heaps[id].heap : NULL;
+}
+
+#if USE_OS_ALLOC_SLAB
+os_slab_t * os_get_slab(void) {
+  return &os_slab;
+}
+#endif
+
 void * os_alloc(size_t size) {
-  return os_heap_alloc(os_heap, size);
+  return os_alloc_impl(os_heap, size, 0);
+}
+
+void * os_alloc_from(os_heap_id_t id, size_t size) {
+  return os_alloc_impl(os_get_heap_by_id(id), size, 0);
+}
+
+void * os_alloc_aligned(os_heap_id_t id, size_t size, size_t align) {
+  ASSERT_RETURN(align && (align & (align - 1)) == 0, NULL);
+  return os_alloc_impl(os_get_heap_by_id(id), size, align);
+}
+
+void * os_alloc_placed(size_t size, uint8_t flags) {
+  void * ptr = os_alloc_match(size, flags);
+
+  if (!ptr && (flags & OS_HEAP_FAST)) {
+    ptr = os_alloc_match(size, flags & ~OS_HEAP_FAST);
+  }
+
+  return ptr;
+}
+
+void * os_realloc(void * ptr, size_t size) {
+  if (!size) {
+    if (ptr) {
+      os_free(ptr);
+    }
+    return NULL;
+  }
+
+  if (!ptr) {
+    return os_alloc(size);
+  }
+
+#if OS_STAT_TRACE_TASK_HEAP
+  os_alloc_tag_t * tag = (os_alloc_tag_t *) ptr - 1;
+  os_task_t * owner = tag->owner;
+  size_t old_size = tag->size;
+
+  if (owner && owner->heap.quota && size > old_size
+      && owner->heap.used - old_size + size > owner->heap.quota) {
+    log_warn("os_realloc: task '%s' heap quota exceeded (%u+%u > %u)",
+             owner->name, owner->heap.used, size - old_size, owner->heap.quota);
+    return NULL;
+  }
+
+  if (os_alloc_resize_raw(tag->heap, (uint8_t *) ptr - tag->offset, size + tag->offset)) {
+    tag->size = size;
+
+    if (owner) {
+      owner->heap.used = owner->heap.used - old_size + size;
+
+      if (owner->heap.used > owner->heap.peak) {
+        owner->heap.peak = owner->heap.used;
+      }
+    }
+
+    return ptr;
+  }
+
+  // Quota was checked for the delta above, new block keeps the owner,
+  // old one is uncharged by os_free below
+  void * result = os_alloc_tagged(tag->heap, size, 0, owner);
+#else
+  size_t old_size = os_alloc_raw_size(ptr);
+
+  if (os_alloc_resize_raw(NULL, ptr, size)) {
+    return ptr;
+  }
+
+  void * result = os_alloc_impl(os_alloc_find_heap(ptr), size, 0);
+#endif
+
+  if (!result) {
+    return NULL;
+  }
+
+  memcpy(result, ptr, UTIL_MIN(old_size, size));
+  os_free(ptr);
+
+  return result;
 }
 
 error_t os_free(void * ptr) {
-  return os_heap_free(os_heap, ptr);
+#if OS_STAT_TRACE_TASK_HEAP
+  ASSERT_RETURN(ptr, E_INVAL);
+
+  os_alloc_tag_t * tag = (os_alloc_tag_t *) ptr - 1;
+  os_task_t * owner = tag->owner;
+  size_t size = tag->size;
+
+  ERROR_CHECK_RETURN(os_free_raw(tag->heap, (uint8_t *) ptr - tag->offset));
+
+  if (owner) {
+    owner->heap.used -= size;
+  }
+
+  return E_OK;
+#else
+  return os_free_raw(NULL, ptr);
+#endif
 }
 
 error_t os_defrag(void) {
-  return os_heap_defrag(os_heap);
+  for (size_t i = 0; i < os_heaps_count; ++i) {
+    ERROR_CHECK_RETURN(os_heap_defrag(os_heaps[i].heap));
+  }
+
+  return E_OK;
 }
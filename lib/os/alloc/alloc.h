@@ -7,6 +7,10 @@
  * @brief Allocator. os_alloc = malloc, os_free = free. To use, a heap must
  *        be created with a buffer
  *
+ * Several heaps (e.g. fast/CCM RAM, DMA-capable RAM, bulk RAM) can be
+ * registered with os_add_heap, os_alloc_from/os_alloc_placed place
+ * allocations into them, os_free finds the owning heap by address.
+ *
  *  ========================================================================= */
 #pragma once
 
@@ -17,41 +21,206 @@ extern "C" {
 /* Includes ================================================================= */
 #include "os/heap/heap.h"
 #include "error/error.h"
+#include "util/util.h"
 
 /* Defines ================================================================== */
+/**
+ * Serve small allocations (up to OS_SLAB_CLASS_MAX) from size-class slab,
+ * carved out of os_heap in os_use_heap
+ */
+#ifndef USE_OS_ALLOC_SLAB
+#define USE_OS_ALLOC_SLAB 0
+#endif
+
+#if USE_OS_ALLOC_SLAB
+#include "os/alloc/slab.h"
+#endif
+
+/**
+ * Maximum number of registered heaps
+ */
+#ifndef OS_ALLOC_HEAP_COUNT
+#define OS_ALLOC_HEAP_COUNT 4
+#endif
+
+/**
+ * Invalid heap id
+ */
+#define OS_HEAP_ID_INVALID 0xFF
+
 /* Macros =================================================================== */
+/**
+ * Creates a heap over a linker-defined region and registers it
+ *
+ * Linker script must define __os_heap_<name>_start & __os_heap_<name>_end,
+ * similar to __os_heap_start/__os_heap_end, e.g.:
+ *
+ *   .os_heap_fast (NOLOAD) : {
+ *     __os_heap_fast_start = .;
+ *     . = ORIGIN(CCMRAM) + LENGTH(CCMRAM);
+ *     __os_heap_fast_end = .;
+ *   } > CCMRAM
+ *
+ * @param __name Heap name (identifier, also used as registry name)
+ * @param __flags os_heap_flags_t describing the region
+ */
+#define OS_ADD_LINKER_HEAP(__name, __flags)                                     \
+  do {                                                                          \
+    extern uint8_t UTIL_CAT(__os_heap_, UTIL_CAT(__name, _start))[];            \
+    extern uint8_t UTIL_CAT(__os_heap_, UTIL_CAT(__name, _end))[];              \
+    static os_heap_t UTIL_CAT(__name, _os_heap);                                \
+    os_add_heap_region(                                                         \
+      &UTIL_CAT(__name, _os_heap), UTIL_STRINGIFY(__name), __flags,             \
+      UTIL_CAT(__os_heap_, UTIL_CAT(__name, _start)),                           \
+      UTIL_CAT(__os_heap_, UTIL_CAT(__name, _end))                              \
+        - UTIL_CAT(__os_heap_, UTIL_CAT(__name, _start))                        \
+    );                                                                          \
+  } while (0)
+
 /* Enums ==================================================================== */
+/**
+ * Heap placement flags
+ *
+ * Describe heap capabilities in os_add_heap and requirements in
+ * os_alloc_placed
+ */
+typedef enum {
+  OS_HEAP_ANY  = 0,         /** No requirements */
+  OS_HEAP_FAST = (1 << 0),  /** Fast memory, preference - falls back to other heaps */
+  OS_HEAP_DMA  = (1 << 1),  /** DMA-capable memory, requirement - never falls back */
+} os_heap_flags_t;
+
 /* Types ==================================================================== */
+/**
+ * Registered heap id
+ */
+typedef uint8_t os_heap_id_t;
+
 /* Variables ================================================================ */
 /* Shared functions ========================================================= */
 /**
- * Sets internal OS heap
+ * Sets internal OS heap (default heap for os_alloc)
+ *
+ * @note Heap is registered as "os" with OS_HEAP_ANY, if it wasn't yet
  *
  * @param heap Heap Context to use
  */
 error_t os_use_heap(os_heap_t * heap);
 
+/**
+ * Registers a heap
+ *
+ * @note First registered heap becomes default, if os_use_heap wasn't called
+ *
+ * @param heap Heap Context
+ * @param name Heap name
+ * @param flags Heap capabilities (os_heap_flags_t)
+ */
+error_t os_add_heap(os_heap_t * heap, const char * name, uint8_t flags);
+
+/**
+ * Creates a heap over memory region and registers it
+ *
+ * @param heap Heap Context
+ * @param name Heap name
+ * @param flags Heap capabilities (os_heap_flags_t)
+ * @param start Region start
+ * @param size Region size
+ */
+error_t os_add_heap_region(os_heap_t * heap, const char * name, uint8_t flags, void * start, size_t size);
+
+/**
+ * Finds registered heap by name
+ *
+ * @param name Heap name
+ * @retval Heap id or OS_HEAP_ID_INVALID
+ */
+os_heap_id_t os_get_heap_id(const char * name);
+
+/**
+ * Returns registered heap by id
+ *
+ * @param id Heap id
+ * @retval Heap, or NULL if id is invalid
+ */
+os_heap_t * os_get_heap_by_id(os_heap_id_t id);
+
 /**
  * Returns internal OS heap
  */
 os_heap_t * os_get_heap(void);
 
+#if USE_OS_ALLOC_SLAB
+/**
+ * Returns slab used by os_alloc for small allocations
+ */
+os_slab_t * os_get_slab(void);
+#endif
+
 /**
  * Allocates memory from internal OS heap
  *
+ * @note If OS_STAT_TRACE_TASK_HEAP is enabled, allocation is attributed to
+ *       current task, and fails if task heap quota would be exceeded
+ *
  * @param size Size of allocation
  */
 void * os_alloc(size_t size);
 
 /**
- * Returns memory to internal OS heap
+ * Allocates memory from a specific heap
+ *
+ * @param id Heap id
+ * @param size Size of allocation
+ */
+void * os_alloc_from(os_heap_id_t id, size_t size);
+
+/**
+ * Allocates aligned memory from a specific heap
+ *
+ * @param id Heap id
+ * @param size Size of allocation
+ * @param align Alignment, power of 2
+ */
+void * os_alloc_aligned(os_heap_id_t id, size_t size, size_t align);
+
+/**
+ * Allocates memory from first heap, matching flags
+ *
+ * Heaps are tried in registration order. If none of the heaps with all
+ * flags has space, OS_HEAP_FAST is dropped and heaps are tried again.
+ * OS_HEAP_DMA is never dropped.
+ *
+ * @param size Size of allocation
+ * @param flags Placement requirements (os_heap_flags_t)
+ */
+void * os_alloc_placed(size_t size, uint8_t flags);
+
+/**
+ * Resizes memory allocated with os_alloc*
+ *
+ * Block is resized in place when possible (see os_heap_resize), and is
+ * moved to the same heap otherwise. Behaves as os_alloc if ptr is NULL,
+ * and as os_free if size is 0.
+ *
+ * @note Alignment of os_alloc_aligned blocks is not kept, if block has
+ *       to be moved
+ *
+ * @param ptr Memory that was previously allocated, or NULL
+ * @param size New size
+ * @retval New pointer, or NULL if allocation failed (ptr is still valid)
+ */
+void * os_realloc(void * ptr, size_t size);
+
+/**
+ * Returns memory to the heap it was allocated from
  *
  * @param ptr Memory that was previously allocated
  */
 error_t os_free(void * ptr);
 
 /**
- * Defragments the os_heap
+ * Defragments all registered heaps
  */
 error_t os_defrag(void);
 
@@ -0,0 +1,202 @@
+/** ========================================================================= *
+ *
+ * @file slab.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Size-class slab allocator, front-end for os_alloc
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/alloc/slab.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+_Static_assert((OS_SLAB_CLASS_MIN & (OS_SLAB_CLASS_MIN - 1)) == 0,
+               "OS_SLAB_CLASS_MIN must be power of 2");
+_Static_assert(OS_SLAB_CLASS_MAX <= OS_SLAB_PAGE_SIZE,
+               "Biggest slab class must fit into a page");
+
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Maps size to class index (size must be <= OS_SLAB_CLASS_MAX)
+ */
+__STATIC_INLINE size_t os_slab_class_index(size_t size) {
+  if (size <= OS_SLAB_CLASS_MIN) {
+    return 0;
+  }
+
+  return (size_t) (32 - __builtin_clz((uint32_t) (size - 1)) - __builtin_ctz(OS_SLAB_CLASS_MIN));
+}
+
+__STATIC_INLINE void os_slab_partial_push(os_slab_class_t * cls, os_slab_page_t * page) {
+  page->prev = NULL;
+  page->next = cls->partial;
+
+  if (cls->partial) {
+    cls->partial->prev = page;
+  }
+
+  cls->partial = page;
+}
+
+__STATIC_INLINE void os_slab_partial_remove(os_slab_class_t * cls, os_slab_page_t * page) {
+  if (page->prev) {
+    page->prev->next = page->next;
+  } else {
+    cls->partial = page->next;
+  }
+
+  if (page->next) {
+    page->next->prev = page->prev;
+  }
+
+  page->next = NULL;
+  page->prev = NULL;
+}
+
+/**
+ * Takes an unassigned page and gives it to a class
+ */
+__STATIC_INLINE os_slab_page_t * os_slab_page_assign(os_slab_t * slab, size_t cls) {
+  os_slab_page_t * page = slab->free_pages;
+
+  if (!page) {
+    return NULL;
+  }
+
+  slab->free_pages = page->next;
+
+  size_t elem_size = os_slab_class_size(cls);
+
+  os_pool_init(
+    &page->pool,
+    slab->region + (size_t) (page - slab->pages) * OS_SLAB_PAGE_SIZE,
+    elem_size,
+    OS_SLAB_PAGE_SIZE / elem_size
+  );
+
+  page->cls = (int8_t) cls;
+
+  slab->classes[cls].pages++;
+  os_slab_partial_push(&slab->classes[cls], page);
+
+  return page;
+}
+
+/**
+ * Returns an empty page to unassigned list
+ */
+__STATIC_INLINE void os_slab_page_release(os_slab_t * slab, os_slab_page_t * page) {
+  os_slab_class_t * cls = &slab->classes[page->cls];
+
+  os_slab_partial_remove(cls, page);
+  cls->pages--;
+
+  page->cls = -1;
+  page->next = slab->free_pages;
+  slab->free_pages = page;
+}
+
+/* Shared functions ========================================================= */
+error_t os_slab_init(os_slab_t * slab, void * region) {
+  ASSERT_RETURN(slab && region, E_NULL);
+  ASSERT_RETURN(((size_t) region & (sizeof(void *) - 1)) == 0, E_INVAL);
+
+  memset(slab, 0, sizeof(os_slab_t));
+
+  slab->region = region;
+
+  for (size_t i = OS_SLAB_PAGE_COUNT; i > 0; --i) {
+    os_slab_page_t * page = &slab->pages[i - 1];
+    page->cls = -1;
+    page->next = slab->free_pages;
+    slab->free_pages = page;
+  }
+
+  return E_OK;
+}
+
+void * os_slab_alloc(os_slab_t * slab, size_t size) {
+  if (!slab || !slab->region || !size || size > OS_SLAB_CLASS_MAX) {
+    return NULL;
+  }
+
+  size_t index = os_slab_class_index(size);
+  os_slab_class_t * cls = &slab->classes[index];
+
+  os_slab_page_t * page = cls->partial;
+
+  if (!page) {
+    page = os_slab_page_assign(slab, index);
+
+    if (!page) {
+      cls->fallbacks++;
+      return NULL;
+    }
+  }
+
+  void * ptr = os_pool_alloc(&page->pool);
+
+  if (page->pool.used == page->pool.count) {
+    os_slab_partial_remove(cls, page);
+  }
+
+  cls->allocs++;
+  cls->used++;
+
+  if (cls->used > cls->peak) {
+    cls->peak = cls->used;
+  }
+
+  return ptr;
+}
+
+error_t os_slab_free(os_slab_t * slab, void * ptr) {
+  ASSERT_RETURN(slab, E_NULL);
+  ASSERT_RETURN(os_slab_contains(slab, ptr), E_NOTFOUND);
+
+  os_slab_page_t * page = &slab->pages[((uint8_t *) ptr - slab->region) / OS_SLAB_PAGE_SIZE];
+
+  ASSERT_RETURN(page->cls >= 0, E_INVAL);
+
+  os_slab_class_t * cls = &slab->classes[page->cls];
+  bool was_full = page->pool.used == page->pool.count;
+
+  ERROR_CHECK_RETURN(os_pool_free(&page->pool, ptr));
+
+  cls->used--;
+
+  if (was_full) {
+    os_slab_partial_push(cls, page);
+  }
+
+  if (!page->pool.used) {
+    os_slab_page_release(slab, page);
+  }
+
+  return E_OK;
+}
+
+bool os_slab_contains(os_slab_t * slab, void * ptr) {
+  return slab && slab->region
+      && (uint8_t *) ptr >= slab->region
+      && (uint8_t *) ptr < slab->region + OS_SLAB_REGION_SIZE;
+}
+
+size_t os_slab_block_size(os_slab_t * slab, void * ptr) {
+  if (!os_slab_contains(slab, ptr)) {
+    return 0;
+  }
+
+  os_slab_page_t * page = &slab->pages[((uint8_t *) ptr - slab->region) / OS_SLAB_PAGE_SIZE];
+
+  return page->cls >= 0 ? os_slab_class_size(page->cls) : 0;
+}
@@ -0,0 +1,161 @@
+/** ========================================================================= *
+ *
+ * @file slab.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Size-class slab allocator, front-end for os_alloc
+ *
+ * A region is split into equal pages, every page serves a single size
+ * class (OS_SLAB_CLASS_MIN << n) through an os_pool. Pages are assigned
+ * to classes on demand and returned when they become empty. Owning page
+ * of a pointer is found by its offset in the region, so alloc and free
+ * are O(1).
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "os/pool/pool.h"
+#include "error/error.h"
+
+/* Defines ================================================================== */
+/**
+ * Size of a slab page
+ */
+#ifndef OS_SLAB_PAGE_SIZE
+#define OS_SLAB_PAGE_SIZE 256
+#endif
+
+/**
+ * Slab page count
+ */
+#ifndef OS_SLAB_PAGE_COUNT
+#define OS_SLAB_PAGE_COUNT 16
+#endif
+
+/**
+ * Smallest size class (power of 2)
+ */
+#ifndef OS_SLAB_CLASS_MIN
+#define OS_SLAB_CLASS_MIN 8
+#endif
+
+/**
+ * Size class count, classes are OS_SLAB_CLASS_MIN << n
+ */
+#ifndef OS_SLAB_CLASS_COUNT
+#define OS_SLAB_CLASS_COUNT 5
+#endif
+
+/**
+ * Biggest size served by slab
+ */
+#define OS_SLAB_CLASS_MAX (OS_SLAB_CLASS_MIN << (OS_SLAB_CLASS_COUNT - 1))
+
+/**
+ * Size of region, managed by slab
+ */
+#define OS_SLAB_REGION_SIZE (OS_SLAB_PAGE_SIZE * OS_SLAB_PAGE_COUNT)
+
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Slab Page
+ */
+typedef struct os_slab_page_s {
+  os_pool_t pool;                    /** Elements of this page */
+  struct os_slab_page_s * next;      /** Next page in class partial list or free page list */
+  struct os_slab_page_s * prev;      /** Prev page in class partial list */
+  int8_t cls;                        /** Size class index, -1 if unassigned */
+} os_slab_page_t;
+
+/**
+ * Slab Size Class
+ */
+typedef struct {
+  os_slab_page_t * partial;          /** Pages with free elements */
+
+  /** Statistics */
+  size_t pages;                      /** Pages assigned to class */
+  size_t used;                       /** Elements allocated */
+  size_t peak;                       /** High-water mark of used */
+  size_t allocs;                     /** Total allocations */
+  size_t fallbacks;                  /** Allocations that didn't fit into slab */
+} os_slab_class_t;
+
+/**
+ * Slab Context
+ */
+typedef struct {
+  uint8_t * region;                  /** Memory of all pages */
+  os_slab_page_t * free_pages;       /** Unassigned pages */
+  os_slab_page_t pages[OS_SLAB_PAGE_COUNT];
+  os_slab_class_t classes[OS_SLAB_CLASS_COUNT];
+} os_slab_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes slab
+ *
+ * @param slab Slab Context
+ * @param region Memory of OS_SLAB_REGION_SIZE bytes, aligned to pointer size
+ */
+error_t os_slab_init(os_slab_t * slab, void * region);
+
+/**
+ * Allocates memory from slab
+ *
+ * @param slab Slab Context
+ * @param size Allocation size
+ * @retval Pointer, or NULL if size is too big or class has no space
+ *         (caller should fall back to heap)
+ */
+void * os_slab_alloc(os_slab_t * slab, size_t size);
+
+/**
+ * Returns memory to slab
+ *
+ * @param slab Slab Context
+ * @param ptr Pointer previously allocated from slab
+ */
+error_t os_slab_free(os_slab_t * slab, void * ptr);
+
+/**
+ * Checks if ptr belongs to slab region
+ *
+ * @param slab Slab Context
+ * @param ptr Pointer to check
+ */
+bool os_slab_contains(os_slab_t * slab, void * ptr);
+
+/**
+ * Returns usable size of a block allocated from slab
+ *
+ * @param slab Slab Context
+ * @param ptr Pointer previously allocated from slab
+ * @retval Element size of the block class, 0 if ptr isn't from slab
+ */
+size_t os_slab_block_size(os_slab_t * slab, void * ptr);
+
+/**
+ * Returns element size of a class
+ *
+ * @param cls Class index
+ */
+__STATIC_INLINE size_t os_slab_class_size(size_t cls) {
+  return (size_t) OS_SLAB_CLASS_MIN << cls;
+}
+
+#ifdef __cplusplus
+}
+#endif
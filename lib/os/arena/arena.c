@@ -0,0 +1,150 @@
+/** ========================================================================= *
+ *
+ * @file arena.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Arena (bump) allocator for short-lived scratch memory
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/arena/arena.h"
+#include "error/assertion.h"
+#include "log/log.h"
+
+/* Defines ================================================================== */
+#define LOG_TAG arena
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Try to bump-allocate from a region
+ */
+__STATIC_INLINE void * os_arena_bump(
+    uint8_t * base, size_t size, size_t * offset, size_t alloc_size, size_t align
+) {
+  size_t addr = ((size_t) base + *offset + align - 1) & ~(align - 1);
+  size_t end = addr - (size_t) base + alloc_size;
+
+  if (end > size || end < *offset) {
+    return NULL;
+  }
+
+  *offset = end;
+
+  return (void *) addr;
+}
+
+/**
+ * Chains a new block, big enough for size & align
+ */
+__STATIC_INLINE error_t os_arena_grow(os_arena_t * arena, size_t size, size_t align) {
+  size_t block_size = size + align;
+
+  if (block_size < arena->block_size) {
+    block_size = arena->block_size;
+  }
+
+  os_arena_block_t * block = os_heap_alloc(arena->heap, sizeof(os_arena_block_t) + block_size);
+
+  if (!block) {
+    log_debug("os_arena_grow(%u): no memory", block_size);
+    return E_NOMEM;
+  }
+
+  block->prev = arena->chain;
+  block->size = block_size;
+
+  arena->chain = block;
+  arena->offset = 0;
+
+  return E_OK;
+}
+
+/* Shared functions ========================================================= */
+error_t os_arena_init(os_arena_t * arena, void * buffer, size_t size) {
+  ASSERT_RETURN(arena, E_NULL);
+
+  arena->start = buffer;
+  arena->size = buffer ? size : 0;
+  arena->offset = 0;
+  arena->chain = NULL;
+  arena->heap = NULL;
+  arena->block_size = 0;
+  arena->peak = 0;
+
+  return E_OK;
+}
+
+error_t os_arena_set_heap(os_arena_t * arena, os_heap_t * heap, size_t block_size) {
+  ASSERT_RETURN(arena, E_NULL);
+
+  arena->heap = heap;
+  arena->block_size = block_size;
+
+  return E_OK;
+}
+
+void * os_arena_alloc(os_arena_t * arena, size_t size) {
+  return os_arena_alloc_aligned(arena, size, OS_ARENA_ALIGN);
+}
+
+void * os_arena_alloc_aligned(os_arena_t * arena, size_t size, size_t align) {
+  ASSERT_RETURN(arena, NULL);
+  ASSERT_RETURN(align && (align & (align - 1)) == 0, NULL);
+
+  void * ptr;
+
+  if (arena->chain) {
+    ptr = os_arena_bump(arena->chain->data, arena->chain->size, &arena->offset, size, align);
+  } else {
+    ptr = os_arena_bump(arena->start, arena->size, &arena->offset, size, align);
+
+    if (arena->offset > arena->peak) {
+      arena->peak = arena->offset;
+    }
+  }
+
+  if (!ptr && arena->heap && os_arena_grow(arena, size, align) == E_OK) {
+    ptr = os_arena_bump(arena->chain->data, arena->chain->size, &arena->offset, size, align);
+  }
+
+  return ptr;
+}
+
+os_arena_mark_t os_arena_mark(os_arena_t * arena) {
+  os_arena_mark_t mark = {0};
+
+  if (arena) {
+    mark.block = arena->chain;
+    mark.offset = arena->offset;
+  }
+
+  return mark;
+}
+
+error_t os_arena_reset_to_mark(os_arena_t * arena, os_arena_mark_t mark) {
+  ASSERT_RETURN(arena, E_NULL);
+
+  while (arena->chain && arena->chain != mark.block) {
+    os_arena_block_t * prev = arena->chain->prev;
+    os_heap_free(arena->heap, arena->chain);
+    arena->chain = prev;
+  }
+
+  ASSERT_RETURN(arena->chain == mark.block, E_INVAL);
+
+  arena->offset = mark.offset;
+
+  return E_OK;
+}
+
+error_t os_arena_reset(os_arena_t * arena) {
+  os_arena_mark_t mark = {0};
+  return os_arena_reset_to_mark(arena, mark);
+}
@@ -0,0 +1,163 @@
+/** ========================================================================= *
+ *
+ * @file arena.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Arena (bump) allocator for short-lived scratch memory
+ *
+ * Allocation is a pointer increment inside a fixed region, there is no
+ * per-allocation free - memory is released all at once with
+ * os_arena_reset or down to a previously taken mark with
+ * os_arena_reset_to_mark (for nested scopes).
+ *
+ * If a heap is attached (os_arena_set_heap), arena grows by chaining extra
+ * blocks from it, those are returned on reset.
+ *
+ * @code{.c}
+ * OS_ARENA_DEFINE(scratch, 512);
+ *
+ * os_arena_mark_t mark = os_arena_mark(&scratch);
+ * char * line = os_arena_alloc(&scratch, 64);
+ * ...
+ * os_arena_reset_to_mark(&scratch, mark);
+ * @endcode
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stddef.h>
+#include <stdint.h>
+#include "os/heap/heap.h"
+#include "error/error.h"
+#include "util/compiler.h"
+#include "util/util.h"
+
+/* Defines ================================================================== */
+/**
+ * Default alignment of os_arena_alloc
+ */
+#ifndef OS_ARENA_ALIGN
+#define OS_ARENA_ALIGN 8
+#endif
+
+/* Macros =================================================================== */
+/**
+ * Defines an arena with static buffer
+ *
+ * Creates 2 variables - buffer (name+_os_arena_buffer) and arena context
+ *
+ * @param __name Arena name
+ * @param __size Buffer size
+ */
+#define OS_ARENA_DEFINE(__name, __size)                                         \
+  uint8_t UTIL_CAT(__name, _os_arena_buffer)[__size] __ALIGN(OS_ARENA_ALIGN);  \
+  os_arena_t __name = {                                                         \
+    .start = UTIL_CAT(__name, _os_arena_buffer),                                \
+    .size = (__size),                                                           \
+  }
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Extra block, chained from heap
+ */
+typedef struct os_arena_block_s {
+  struct os_arena_block_s * prev; /** Previously chained block */
+  size_t size;                    /** Size of data */
+  uint8_t data[] __ALIGN(OS_ARENA_ALIGN);
+} os_arena_block_t;
+
+/**
+ * Arena Context
+ */
+typedef struct {
+  uint8_t * start;                /** Base region */
+  size_t size;                    /** Base region size */
+  size_t offset;                  /** Bump offset in current block */
+  os_arena_block_t * chain;       /** Current extra block, NULL if base region is current */
+
+  os_heap_t * heap;               /** Heap for extra blocks, NULL to disable chaining */
+  size_t block_size;              /** Minimal size of extra block */
+
+  size_t peak;                    /** High-water mark of offset in base region */
+} os_arena_t;
+
+/**
+ * Arena position, see os_arena_mark
+ */
+typedef struct {
+  os_arena_block_t * block;
+  size_t offset;
+} os_arena_mark_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes an arena
+ *
+ * @param arena Arena Context
+ * @param buffer Base region
+ * @param size Base region size
+ */
+error_t os_arena_init(os_arena_t * arena, void * buffer, size_t size);
+
+/**
+ * Attaches a heap, arena will chain extra blocks from it when base region
+ * is exhausted
+ *
+ * @param arena Arena Context
+ * @param heap Heap, NULL to disable chaining
+ * @param block_size Minimal size of extra block
+ */
+error_t os_arena_set_heap(os_arena_t * arena, os_heap_t * heap, size_t block_size);
+
+/**
+ * Allocates memory aligned to OS_ARENA_ALIGN
+ *
+ * @param arena Arena Context
+ * @param size Allocation size
+ * @retval Pointer, or NULL if arena is exhausted
+ */
+void * os_arena_alloc(os_arena_t * arena, size_t size);
+
+/**
+ * Allocates memory with custom alignment
+ *
+ * @param arena Arena Context
+ * @param size Allocation size
+ * @param align Alignment, power of 2
+ * @retval Pointer, or NULL if arena is exhausted
+ */
+void * os_arena_alloc_aligned(os_arena_t * arena, size_t size, size_t align);
+
+/**
+ * Returns current arena position
+ *
+ * @param arena Arena Context
+ */
+os_arena_mark_t os_arena_mark(os_arena_t * arena);
+
+/**
+ * Releases everything, allocated after mark was taken
+ *
+ * @param arena Arena Context
+ * @param mark Mark, returned from os_arena_mark
+ */
+error_t os_arena_reset_to_mark(os_arena_t * arena, os_arena_mark_t mark);
+
+/**
+ * Releases all allocations, returns extra blocks to heap
+ *
+ * @param arena Arena Context
+ */
+error_t os_arena_reset(os_arena_t * arena);
+
+#ifdef __cplusplus
+}
+#endif
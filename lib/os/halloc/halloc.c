@@ -0,0 +1,250 @@
+/** ========================================================================= *
+ *
+ * @file halloc.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Handle-based relocatable allocator
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/halloc/halloc.h"
+#include "error/assertion.h"
+#include "log/log.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+#define LOG_TAG halloc
+
+/** Size of block header, keeping payload aligned */
+#define OS_HALLOC_HEADER_SIZE OS_HALLOC_ALIGN_UP(sizeof(os_halloc_block_t))
+
+/* Macros =================================================================== */
+/** Align value up to OS_HALLOC_ALIGN */
+#define OS_HALLOC_ALIGN_UP(__x) \
+  (((__x) + OS_HALLOC_ALIGN - 1) & ~((size_t) OS_HALLOC_ALIGN - 1))
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE os_halloc_block_t * os_halloc_block_at(os_halloc_t * halloc, size_t offset) {
+  return (os_halloc_block_t *) (halloc->start + offset);
+}
+
+__STATIC_INLINE os_halloc_entry_t * os_halloc_entry(os_halloc_t * halloc, os_hhandle_t handle) {
+  if (handle == OS_HHANDLE_INVALID || handle > halloc->count) {
+    return NULL;
+  }
+
+  os_halloc_entry_t * entry = &halloc->table[handle - 1];
+
+  return entry->ptr ? entry : NULL;
+}
+
+/**
+ * Lowers top over trailing holes
+ */
+__STATIC_INLINE void os_halloc_trim_top(os_halloc_t * halloc) {
+  size_t offset = 0;
+  size_t last_live_end = 0;
+
+  while (offset < halloc->top) {
+    os_halloc_block_t * block = os_halloc_block_at(halloc, offset);
+
+    offset += OS_HALLOC_HEADER_SIZE + block->size;
+
+    if (block->handle != OS_HHANDLE_INVALID) {
+      last_live_end = offset;
+    }
+  }
+
+  halloc->top = last_live_end;
+}
+
+/* Shared functions ========================================================= */
+error_t os_halloc_init(
+    os_halloc_t * halloc, void * memory, size_t size, os_halloc_entry_t * table, size_t count
+) {
+  ASSERT_RETURN(halloc && memory && table, E_NULL);
+  ASSERT_RETURN(((size_t) memory & (OS_HALLOC_ALIGN - 1)) == 0, E_INVAL);
+  ASSERT_RETURN(count && count < UINT16_MAX, E_INVAL);
+
+  halloc->start = memory;
+  halloc->size = size & ~((size_t) OS_HALLOC_ALIGN - 1);
+  halloc->table = table;
+  halloc->count = count;
+  halloc->top = 0;
+  halloc->used = 0;
+  halloc->moved = 0;
+
+  memset(table, 0, sizeof(os_halloc_entry_t) * count);
+
+  return E_OK;
+}
+
+os_hhandle_t os_halloc(os_halloc_t * halloc, size_t size) {
+  ASSERT_RETURN(halloc && size, OS_HHANDLE_INVALID);
+
+  size_t need = OS_HALLOC_HEADER_SIZE + OS_HALLOC_ALIGN_UP(size);
+
+  if (halloc->size - halloc->used < need) {
+    log_debug("os_halloc(%u): no memory", size);
+    return OS_HHANDLE_INVALID;
+  }
+
+  os_hhandle_t handle = OS_HHANDLE_INVALID;
+
+  for (size_t i = 0; i < halloc->count; ++i) {
+    if (!halloc->table[i].ptr) {
+      handle = (os_hhandle_t) (i + 1);
+      break;
+    }
+  }
+
+  if (handle == OS_HHANDLE_INVALID) {
+    log_debug("os_halloc(%u): no free handles", size);
+    return OS_HHANDLE_INVALID;
+  }
+
+  if (halloc->size - halloc->top < need) {
+    os_halloc_compact(halloc, 0);
+
+    /* Locked blocks may keep holes below them */
+    if (halloc->size - halloc->top < need) {
+      log_debug("os_halloc(%u): fragmented by locked blocks", size);
+      return OS_HHANDLE_INVALID;
+    }
+  }
+
+  os_halloc_block_t * block = os_halloc_block_at(halloc, halloc->top);
+  block->handle = handle;
+  block->size = need - OS_HALLOC_HEADER_SIZE;
+
+  halloc->table[handle - 1].ptr = (uint8_t *) block + OS_HALLOC_HEADER_SIZE;
+  halloc->table[handle - 1].locks = 0;
+
+  halloc->top += need;
+  halloc->used += need;
+
+  return handle;
+}
+
+error_t os_hfree(os_halloc_t * halloc, os_hhandle_t handle) {
+  ASSERT_RETURN(halloc, E_NULL);
+
+  os_halloc_entry_t * entry = os_halloc_entry(halloc, handle);
+
+  ASSERT_RETURN(entry, E_INVAL);
+
+  os_halloc_block_t * block = (os_halloc_block_t *) (entry->ptr - OS_HALLOC_HEADER_SIZE);
+
+  block->handle = OS_HHANDLE_INVALID;
+
+  halloc->used -= OS_HALLOC_HEADER_SIZE + block->size;
+
+  entry->ptr = NULL;
+  entry->locks = 0;
+
+  if ((uint8_t *) block + OS_HALLOC_HEADER_SIZE + block->size == halloc->start + halloc->top) {
+    os_halloc_trim_top(halloc);
+  }
+
+  return E_OK;
+}
+
+void * os_hlock(os_halloc_t * halloc, os_hhandle_t handle) {
+  ASSERT_RETURN(halloc, NULL);
+
+  os_halloc_entry_t * entry = os_halloc_entry(halloc, handle);
+
+  if (!entry) {
+    return NULL;
+  }
+
+  entry->locks++;
+
+  return entry->ptr;
+}
+
+error_t os_hunlock(os_halloc_t * halloc, os_hhandle_t handle) {
+  ASSERT_RETURN(halloc, E_NULL);
+
+  os_halloc_entry_t * entry = os_halloc_entry(halloc, handle);
+
+  ASSERT_RETURN(entry && entry->locks, E_INVAL);
+
+  entry->locks--;
+
+  return E_OK;
+}
+
+size_t os_hsize(os_halloc_t * halloc, os_hhandle_t handle) {
+  os_halloc_entry_t * entry = halloc ? os_halloc_entry(halloc, handle) : NULL;
+
+  if (!entry) {
+    return 0;
+  }
+
+  return ((os_halloc_block_t *) (entry->ptr - OS_HALLOC_HEADER_SIZE))->size;
+}
+
+error_t os_halloc_compact(os_halloc_t * halloc, size_t budget) {
+  ASSERT_RETURN(halloc, E_NULL);
+
+  size_t src = 0;
+  size_t dst = 0;
+  size_t moved = 0;
+
+  while (src < halloc->top) {
+    os_halloc_block_t * block = os_halloc_block_at(halloc, src);
+    size_t block_size = OS_HALLOC_HEADER_SIZE + block->size;
+
+    if (block->handle == OS_HHANDLE_INVALID) {
+      src += block_size;
+      continue;
+    }
+
+    os_halloc_entry_t * entry = &halloc->table[block->handle - 1];
+
+    if (entry->locks) {
+      /* Pinned, can't move - fill the gap below with a hole */
+      if (dst != src) {
+        os_halloc_block_t * hole = os_halloc_block_at(halloc, dst);
+        hole->handle = OS_HHANDLE_INVALID;
+        hole->size = src - dst - OS_HALLOC_HEADER_SIZE;
+      }
+
+      src += block_size;
+      dst = src;
+      continue;
+    }
+
+    if (dst != src) {
+      /* At least one block is moved per call, even if it's bigger than
+         budget, otherwise big blocks would never move */
+      if (budget && moved && moved + block_size > budget) {
+        /* Out of budget, close the gap with a hole and stop */
+        os_halloc_block_t * hole = os_halloc_block_at(halloc, dst);
+        hole->handle = OS_HHANDLE_INVALID;
+        hole->size = src - dst - OS_HALLOC_HEADER_SIZE;
+        halloc->moved += moved;
+        return E_AGAIN;
+      }
+
+      memmove(halloc->start + dst, block, block_size);
+      entry->ptr = halloc->start + dst + OS_HALLOC_HEADER_SIZE;
+      moved += block_size;
+    }
+
+    src += block_size;
+    dst += block_size;
+  }
+
+  halloc->top = dst;
+  halloc->moved += moved;
+
+  return E_OK;
+}
@@ -0,0 +1,181 @@
+/** ========================================================================= *
+ *
+ * @file halloc.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Handle-based relocatable allocator
+ *
+ * Allocations are referenced by handles instead of pointers. A pointer is
+ * only valid between os_hlock and os_hunlock, so unlocked blocks can be
+ * moved by os_halloc_compact, which slides them down over freed space.
+ * Meant for big, rarely pinned buffers (file contents, log buffers), that
+ * should never fragment memory permanently.
+ *
+ * Memory layout:
+ *   [block][block][hole][block]...[free space (top..size)]
+ *
+ * Allocation bumps the top, freed blocks become holes, that are reclaimed
+ * by compaction (explicitly, or automatically if allocation doesn't fit).
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stddef.h>
+#include <stdint.h>
+#include "error/error.h"
+#include "util/compiler.h"
+#include "util/util.h"
+
+/* Defines ================================================================== */
+/**
+ * Alignment of allocated blocks
+ */
+#ifndef OS_HALLOC_ALIGN
+#define OS_HALLOC_ALIGN 8
+#endif
+
+/**
+ * Invalid handle
+ */
+#define OS_HHANDLE_INVALID 0
+
+/* Macros =================================================================== */
+/**
+ * Defines a handle allocator with static memory
+ *
+ * Creates 3 variables - memory (name+_halloc_memory), handle table
+ * (name+_halloc_table) and allocator context
+ *
+ * @param __name Allocator name
+ * @param __size Memory size
+ * @param __handles Maximum number of live allocations
+ */
+#define OS_HALLOC_DEFINE(__name, __size, __handles)                             \
+  uint8_t UTIL_CAT(__name, _halloc_memory)[__size] __ALIGN(OS_HALLOC_ALIGN);  \
+  os_halloc_entry_t UTIL_CAT(__name, _halloc_table)[__handles];                 \
+  os_halloc_t __name = {                                                        \
+    .start = UTIL_CAT(__name, _halloc_memory),                                  \
+    .size = (__size),                                                           \
+    .table = UTIL_CAT(__name, _halloc_table),                                   \
+    .count = (__handles),                                                       \
+  }
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Allocation handle
+ */
+typedef uint16_t os_hhandle_t;
+
+/**
+ * Handle table entry (master pointer)
+ */
+typedef struct {
+  uint8_t * ptr;              /** Current location of block payload, NULL if entry is free */
+  uint16_t locks;             /** Lock count, locked blocks are never moved */
+} os_halloc_entry_t;
+
+/**
+ * Block header
+ */
+typedef struct {
+  size_t handle;              /** Owning handle, OS_HHANDLE_INVALID for holes */
+  size_t size;                /** Payload size (aligned) */
+} os_halloc_block_t;
+
+/**
+ * Handle Allocator Context
+ */
+typedef struct {
+  uint8_t * start;            /** Memory */
+  size_t size;                /** Memory size */
+  os_halloc_entry_t * table;  /** Handle table */
+  size_t count;               /** Handle table size */
+
+  size_t top;                 /** End of last block */
+  size_t used;                /** Bytes in live blocks (with headers) */
+  size_t moved;               /** Total bytes moved by compaction */
+} os_halloc_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes handle allocator
+ *
+ * @param halloc Allocator Context
+ * @param memory Memory, aligned to OS_HALLOC_ALIGN
+ * @param size Memory size
+ * @param table Handle table
+ * @param count Handle table size
+ */
+error_t os_halloc_init(
+    os_halloc_t * halloc, void * memory, size_t size, os_halloc_entry_t * table, size_t count
+);
+
+/**
+ * Allocates a relocatable block
+ *
+ * @note Compacts memory, if block doesn't fit into free space at the top
+ *
+ * @param halloc Allocator Context
+ * @param size Block size
+ * @retval Handle or OS_HHANDLE_INVALID
+ */
+os_hhandle_t os_halloc(os_halloc_t * halloc, size_t size);
+
+/**
+ * Frees a block
+ *
+ * @param halloc Allocator Context
+ * @param handle Block handle
+ */
+error_t os_hfree(os_halloc_t * halloc, os_hhandle_t handle);
+
+/**
+ * Pins a block and returns pointer to it, pointer is valid until matching
+ * os_hunlock. Locks nest.
+ *
+ * @param halloc Allocator Context
+ * @param handle Block handle
+ * @retval Pointer or NULL if handle is invalid
+ */
+void * os_hlock(os_halloc_t * halloc, os_hhandle_t handle);
+
+/**
+ * Unpins a block
+ *
+ * @param halloc Allocator Context
+ * @param handle Block handle
+ */
+error_t os_hunlock(os_halloc_t * halloc, os_hhandle_t handle);
+
+/**
+ * Returns size of a block
+ *
+ * @param halloc Allocator Context
+ * @param handle Block handle
+ */
+size_t os_hsize(os_halloc_t * halloc, os_hhandle_t handle);
+
+/**
+ * Compacts memory by sliding unlocked blocks over holes
+ *
+ * Can be called periodically (e.g. from idle task) with a budget, to
+ * spread compaction over time
+ *
+ * @param halloc Allocator Context
+ * @param budget Maximum number of bytes to move, 0 - unlimited. At least
+ *               one block is moved per call, even if it's bigger
+ * @retval E_AGAIN if stopped because of budget, call again to continue
+ */
+error_t os_halloc_compact(os_halloc_t * halloc, size_t budget);
+
+#ifdef __cplusplus
+}
+#endif
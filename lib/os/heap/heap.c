@@ -6,12 +6,16 @@
  *
  * @brief Heap Implementation
  *
+ * Common part of the heap API, allocation strategy is implemented by
+ * backends (heap_first_fit.c, heap_tlsf.c)
+ *
  *  ========================================================================= */
 
 /* Includes ================================================================= */
 #include "os/heap/heap.h"
 #include "error/assertion.h"
 #include "log/log.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define LOG_TAG heap
@@ -22,85 +26,133 @@
 /* Types ==================================================================== */
 /* Variables ================================================================ */
 /* Private functions ======================================================== */
-__STATIC_INLINE void * os_heap_alloc_impl(os_heap_block_t * block, size_t size) {
-  if (!block) {
-    log_error("os_heap_alloc: bad block");
-    return NULL;
-  }
-
-  if (block->state == OS_HEAP_BLOCK_USED) {
-    if (block->next) {
-      return os_heap_alloc_impl(block->next, size);
-    }
-  } else {
-    if (block->size >= size) {
-      os_heap_block_t * new_block =
-          (os_heap_block_t *) ((uint8_t *) block + block->size - size - sizeof(os_heap_block_t));
-
-      new_block->next = NULL;
-      new_block->size = size;
-      new_block->state = OS_HEAP_BLOCK_USED;
-
-      if (block->next) {
-        new_block->next = block->next;
-      }
-
-      block->next = new_block;
-      block->size -= size + sizeof(os_heap_block_t);
+/**
+ * Format heap memory (heap->start, heap->size) as a single free region
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ */
+error_t os_heap_backend_init(os_heap_t * heap);
 
-      uint8_t * result = (uint8_t *) new_block + sizeof(os_heap_block_t);
+/**
+ * Allocate a block of at least size bytes
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param size Requested size
+ */
+void * os_heap_backend_alloc(os_heap_t * heap, size_t size);
 
-      log_debug("os_heap_alloc(%p, %u): new block=%p result=%p",
-                block, size, new_block, result);
+/**
+ * Allocate a block of at least size bytes, aligned to align
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param size Requested size
+ * @param align Alignment, power of 2
+ */
+void * os_heap_backend_alloc_aligned(os_heap_t * heap, size_t size, size_t align);
+
+/**
+ * Return a block to the heap
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer
+ */
+error_t os_heap_backend_free(os_heap_t * heap, void * ptr);
 
-      return (void *) result;
-    } else {
-      if (block->next) {
-        return os_heap_alloc_impl(block->next, size);
-      }
-    }
+/**
+ * Get usable size of an allocated block
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer
+ */
+size_t os_heap_backend_block_size(os_heap_t * heap, void * ptr);
+
+/**
+ * Resize block in place, splitting off the tail or taking space from the
+ * next free block
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer
+ * @param size New size
+ * @retval true if block was resized, false if it has to be moved
+ */
+bool os_heap_backend_resize(os_heap_t * heap, void * ptr, size_t size);
+
+/**
+ * Call cb for every block of the heap in address order
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ * @param cb Callback
+ * @param ctx User context
+ */
+error_t os_heap_backend_walk(os_heap_t * heap, os_heap_walk_cb_t cb, void * ctx);
+
+/**
+ * Merge adjacent free blocks
+ *
+ * @note Implemented by heap backend
+ *
+ * @param heap Heap Context
+ */
+error_t os_heap_backend_defrag(os_heap_t * heap);
+
+/**
+ * os_heap_walk callback for os_heap_stats
+ */
+static void os_heap_stats_walk_cb(void * ctx, void * ptr, size_t size, bool used) {
+  os_heap_stats_t * stats = ctx;
+
+  if (used) {
+    stats->used_blocks++;
+    return;
   }
 
-  log_debug("os_heap_alloc: no memory left");
-  return NULL;
-}
+  stats->free += size;
+  stats->free_blocks++;
 
-__STATIC_INLINE error_t os_heap_free_impl(os_heap_block_t * block, void * ptr) {
-  if (!block) {
-    log_error("os_heap_free: bad block");
-    return E_INVAL;
+  if (size > stats->largest_free) {
+    stats->largest_free = size;
   }
 
-  if (ptr == (uint8_t *) block + sizeof(os_heap_block_t)) {
-    log_debug("os_heap_free(%p): block=%p size=%u", ptr, block, block->size);
-    block->state = OS_HEAP_BLOCK_FREE;
-    return E_OK;
-  }
+  size_t bucket = 0;
 
-  if (block->next) {
-    return os_heap_free_impl(block->next, ptr);
+  while (bucket < OS_HEAP_STATS_HISTOGRAM_SIZE - 1
+      && size >= ((size_t) OS_HEAP_STATS_HISTOGRAM_MIN << bucket)) {
+    bucket++;
   }
 
-  log_error("os_heap_free(%p): block not found", ptr);
-  return E_NOTFOUND;
+  stats->histogram[bucket]++;
 }
 
-__STATIC_INLINE error_t os_heap_defrag_impl(os_heap_block_t * block) {
-  if (!block) {
-    return E_OK;
-  }
+/**
+ * Updates counters after allocation
+ */
+__STATIC_INLINE void * os_heap_account_alloc(os_heap_t * heap, void * result) {
+  if (result) {
+    heap->used += os_heap_backend_block_size(heap, result);
+    heap->allocs++;
 
-  if (block->state != OS_HEAP_BLOCK_USED) {
-    if (block->next && block->next->state != OS_HEAP_BLOCK_USED) {
-      log_debug("os_heap_defrag: merging %p(size=%u) and %p(size=%u)",
-                block, block->size, block->next, block->next->size);
-      block->next = block->next->next;
-      block->size += block->next->size;
-      return os_heap_defrag_impl(block);
+    if (heap->used > heap->peak) {
+      heap->peak = heap->used;
     }
+  } else {
+    heap->fails++;
   }
 
-  return os_heap_defrag_impl(block->next);
+  return result;
 }
 
 /* Shared functions ========================================================= */
@@ -112,12 +164,13 @@ error_t os_heap_create(os_heap_t * heap, void * start, size_t size) {
 
   heap->size = size;
   heap->start = start;
+  heap->used = 0;
+  heap->peak = 0;
+  heap->allocs = 0;
+  heap->frees = 0;
+  heap->fails = 0;
 
-  heap->root_block = (os_heap_block_t *) start;
-
-  heap->root_block->next = NULL;
-  heap->root_block->size = size;
-  heap->root_block->state = OS_HEAP_BLOCK_FREE;
+  ERROR_CHECK_RETURN(os_heap_backend_init(heap));
 
   log_debug("os_heap_create[%p]: %p %u", heap, start, size);
 
@@ -135,56 +188,127 @@ error_t os_heap_destroy(os_heap_t * heap) {
 error_t os_heap_erase(os_heap_t * heap) {
   ASSERT_RETURN(heap, E_NULL);
 
-  memset(heap->root_block, 0, sizeof(os_heap_block_t));
-
-  heap->root_block->next = NULL;
-  heap->root_block->size = heap->size;
-  heap->root_block->state = OS_HEAP_BLOCK_FREE;
+  heap->used = 0;
 
-  return E_OK;
+  return os_heap_backend_init(heap);
 }
 
 void * os_heap_alloc(os_heap_t * heap, size_t size) {
   ASSERT_RETURN(heap, NULL);
 
-  void * result = os_heap_alloc_impl(heap->root_block, size);
-
-#if USE_OS_HEAP_DEFRAG_ON_NO_MEM
-  if (!result) {
-    os_heap_defrag(heap);
-    result = os_heap_alloc_impl(heap->root_block, size);
-  }
-#endif
+  return os_heap_account_alloc(heap, os_heap_backend_alloc(heap, size));
+}
 
-  if (result) {
-    heap->used += size;
-  }
+void * os_heap_alloc_aligned(os_heap_t * heap, size_t size, size_t align) {
+  ASSERT_RETURN(heap, NULL);
+  ASSERT_RETURN(align && (align & (align - 1)) == 0, NULL);
 
-  return result;
+  return os_heap_account_alloc(heap, os_heap_backend_alloc_aligned(heap, size, align));
 }
 
 error_t os_heap_free(os_heap_t * heap, void * ptr) {
   ASSERT_RETURN(heap, E_NULL);
   ASSERT_RETURN(ptr, E_INVAL);
 
-  size_t size = ((os_heap_block_t *)((uint8_t*) ptr - sizeof(os_heap_block_t)))->size;
-
-  error_t err = os_heap_free_impl(heap->root_block, ptr);
+  size_t size = os_heap_backend_block_size(heap, ptr);
 
-#if USE_OS_HEAP_DEFRAG_ON_FREE
-  if (err == E_OK) {
-    err = os_heap_defrag(heap);
-  }
-#endif
+  error_t err = os_heap_backend_free(heap, ptr);
 
   if (err == E_OK) {
     heap->used -= size;
+    heap->frees++;
   }
 
   return err;
 }
 
+error_t os_heap_resize(os_heap_t * heap, void * ptr, size_t size) {
+  ASSERT_RETURN(heap, E_NULL);
+  ASSERT_RETURN(ptr && size, E_INVAL);
+
+  size_t old_size = os_heap_backend_block_size(heap, ptr);
+
+  ASSERT_RETURN(old_size, E_INVAL);
+
+  if (!os_heap_backend_resize(heap, ptr, size)) {
+    return E_NOMEM;
+  }
+
+  heap->used = heap->used - old_size + os_heap_backend_block_size(heap, ptr);
+
+  if (heap->used > heap->peak) {
+    heap->peak = heap->used;
+  }
+
+  return E_OK;
+}
+
+void * os_heap_realloc(os_heap_t * heap, void * ptr, size_t size) {
+  ASSERT_RETURN(heap, NULL);
+
+  if (!size) {
+    if (ptr) {
+      os_heap_free(heap, ptr);
+    }
+    return NULL;
+  }
+
+  if (!ptr) {
+    return os_heap_alloc(heap, size);
+  }
+
+  size_t old_size = os_heap_backend_block_size(heap, ptr);
+
+  ASSERT_RETURN(old_size, NULL);
+
+  if (os_heap_resize(heap, ptr, size) == E_OK) {
+    return ptr;
+  }
+
+  void * result = os_heap_alloc(heap, size);
+
+  if (!result) {
+    return NULL;
+  }
+
+  memcpy(result, ptr, old_size < size ? old_size : size);
+  os_heap_free(heap, ptr);
+
+  return result;
+}
+
+size_t os_heap_block_size(os_heap_t * heap, void * ptr) {
+  ASSERT_RETURN(heap && ptr, 0);
+  return os_heap_backend_block_size(heap, ptr);
+}
+
 error_t os_heap_defrag(os_heap_t * heap) {
   ASSERT_RETURN(heap, E_NULL);
-  return os_heap_defrag_impl(heap->root_block);
+  return os_heap_backend_defrag(heap);
+}
+
+error_t os_heap_walk(os_heap_t * heap, os_heap_walk_cb_t cb, void * ctx) {
+  ASSERT_RETURN(heap && cb, E_NULL);
+  return os_heap_backend_walk(heap, cb, ctx);
+}
+
+error_t os_heap_stats(os_heap_t * heap, os_heap_stats_t * stats) {
+  ASSERT_RETURN(heap && stats, E_NULL);
+
+  memset(stats, 0, sizeof(os_heap_stats_t));
+
+  stats->size = heap->size;
+  stats->used = heap->used;
+  stats->peak = heap->peak;
+  stats->allocs = heap->allocs;
+  stats->frees = heap->frees;
+  stats->fails = heap->fails;
+
+  ERROR_CHECK_RETURN(os_heap_backend_walk(heap, os_heap_stats_walk_cb, stats));
+
+  stats->fragmentation = stats->free
+      ? (uint8_t) (100 - stats->largest_free * 100 / stats->free)
+      : 0;
+
+  return E_OK;
 }
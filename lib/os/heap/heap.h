@@ -6,6 +6,11 @@
  *
  * @brief Heap Implementation
  *
+ * Two backends are available, selected at build time:
+ *   - First-fit (default) - explicit free list, boundary tags, O(1) free
+ *   - TLSF (USE_OS_HEAP_TLSF) - Two-Level Segregated Fit, O(1) alloc/free,
+ *     bounded fragmentation, immediate coalescing
+ *
  *  ========================================================================= */
 #pragma once
 
@@ -16,38 +21,142 @@ extern "C" {
 /* Includes ================================================================= */
 #include <stddef.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include "error/error.h"
 
 /* Defines ================================================================== */
+/**
+ * Use Two-Level Segregated Fit heap backend instead of first-fit
+ */
+#ifndef USE_OS_HEAP_TLSF
+#define USE_OS_HEAP_TLSF 0
+#endif
+
+/**
+ * Alignment of blocks returned by TLSF backend (4, 8 or 16)
+ */
+#ifndef OS_HEAP_TLSF_ALIGN
+#define OS_HEAP_TLSF_ALIGN 8
+#endif
+
+/**
+ * log2 of second level subdivisions per first level class (max 5)
+ * Bigger value means less internal fragmentation, but bigger control block
+ */
+#ifndef OS_HEAP_TLSF_SL_LOG2
+#define OS_HEAP_TLSF_SL_LOG2 4
+#endif
+
+/**
+ * log2 of maximum block size, that TLSF backend can manage
+ * Heap regions, bigger than that, are split into several free blocks
+ */
+#ifndef OS_HEAP_TLSF_FL_MAX
+#define OS_HEAP_TLSF_FL_MAX 17
+#endif
+
+/**
+ * Free block size histogram buckets count (see os_heap_stats_t)
+ */
+#ifndef OS_HEAP_STATS_HISTOGRAM_SIZE
+#define OS_HEAP_STATS_HISTOGRAM_SIZE 8
+#endif
+
+/**
+ * Upper bound of first free block size histogram bucket
+ */
+#ifndef OS_HEAP_STATS_HISTOGRAM_MIN
+#define OS_HEAP_STATS_HISTOGRAM_MIN 32
+#endif
+
+/**
+ * Magic word in block header & footer, used to detect corruption
+ */
+#define OS_HEAP_BLOCK_MAGIC 0x48454150
+
 /* Macros =================================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /**
- * Heap Block Context
+ * Heap Block Header (first-fit backend)
+ *
+ * Every block is surrounded by header and footer (boundary tags), so both
+ * physical neighbours can be reached in O(1)
+ *
+ * @note next & prev overlap with payload and are only valid if the block
+ *       is free
  */
 typedef struct os_heap_block_s {
-  struct os_heap_block_s * next; /** Next Block */
-  size_t size;                   /** Size of current block */
+  uint32_t magic;                /** OS_HEAP_BLOCK_MAGIC */
   enum {
     OS_HEAP_BLOCK_FREE = 0,
     OS_HEAP_BLOCK_USED
   } state;                       /** State of current block (FREE/USED) */
-  uint8_t data[0];
+  size_t size;                   /** Payload size of current block */
+  struct os_heap_block_s * next; /** Next free block */
+  struct os_heap_block_s * prev; /** Previous free block */
 } os_heap_block_t;
 
+/**
+ * Heap Block Footer (first-fit backend)
+ */
+typedef struct {
+  size_t size;                   /** Payload size of current block */
+  uint32_t magic;                /** OS_HEAP_BLOCK_MAGIC */
+} os_heap_block_footer_t;
+
 /**
  * Heap Context
  */
 typedef struct {
-  /** Root Block */
-  os_heap_block_t * root_block;
+  /** Free block list (first-fit backend) */
+  os_heap_block_t * free_list;
 
   /** Heap metadata */
   uint8_t * start;
   size_t size;
   size_t used;
+
+  /** Counters, maintained on every alloc/free */
+  size_t peak;
+  size_t allocs;
+  size_t frees;
+  size_t fails;
 } os_heap_t;
 
+/**
+ * Heap statistics, see os_heap_stats
+ */
+typedef struct {
+  size_t size;                  /** Heap size */
+  size_t used;                  /** Allocated bytes */
+  size_t peak;                  /** High-water mark of used */
+  size_t free;                  /** Bytes in free blocks */
+  size_t used_blocks;           /** Allocated block count */
+  size_t free_blocks;           /** Free block count */
+  size_t largest_free;          /** Largest free block */
+  uint8_t fragmentation;        /** 0 - all free memory is in a single block, 100 - worst */
+  size_t allocs;                /** Successful allocations */
+  size_t frees;                 /** Successful frees */
+  size_t fails;                 /** Failed allocations */
+
+  /**
+   * Free block count by size, bucket n counts blocks smaller than
+   * OS_HEAP_STATS_HISTOGRAM_MIN << n, last bucket counts the rest
+   */
+  size_t histogram[OS_HEAP_STATS_HISTOGRAM_SIZE];
+} os_heap_stats_t;
+
+/**
+ * Heap walk callback, called for every block of the heap in address order
+ *
+ * @param ctx User context
+ * @param ptr Block payload
+ * @param size Block payload size
+ * @param used true if block is allocated
+ */
+typedef void (*os_heap_walk_cb_t)(void * ctx, void * ptr, size_t size, bool used);
+
 /* Variables ================================================================ */
 /* Shared functions ========================================================= */
 /**
@@ -84,6 +193,19 @@ error_t os_heap_erase(os_heap_t * heap);
  */
 void * os_heap_alloc(os_heap_t * heap, size_t size);
 
+/**
+ * Allocate a block of memory with specific alignment
+ *
+ * @note Block is returned with os_heap_free, as usual
+ *
+ * @param heap Heap Context
+ * @param size Size of block to allocate
+ * @param align Alignment, power of 2
+ * @retval Pointer to a block of memory of specified size, or NULL,
+ *         if allocation failed
+ */
+void * os_heap_alloc_aligned(os_heap_t * heap, size_t size, size_t align);
+
 /**
  * Return allocated block of memory to the heap
  *
@@ -93,13 +215,70 @@ void * os_heap_alloc(os_heap_t * heap, size_t size);
 error_t os_heap_free(os_heap_t * heap, void * ptr);
 
 /**
- * Defragment the heap
+ * Resize allocated block in place
  *
- * @note Heaps gets fragmented on every allocation, so defrag operation must be
- *       performed to merge small free blocks.
+ * Shrinking splits off the tail, growing takes space from the next
+ * physical block, if it's free. Block is never moved.
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer
+ * @param size New size
+ * @retval E_NOMEM if block can't be resized in place
+ */
+error_t os_heap_resize(os_heap_t * heap, void * ptr, size_t size);
+
+/**
+ * Resize allocated block
+ *
+ * Tries os_heap_resize first, and falls back to alloc, copy & free only if
+ * block can't be resized in place. Behaves as os_heap_alloc if ptr is NULL,
+ * and as os_heap_free if size is 0.
+ *
+ * @note Alignment of os_heap_alloc_aligned blocks is not kept, if block
+ *       has to be moved
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer or NULL
+ * @param size New size
+ * @retval New pointer, or NULL if allocation failed (ptr is still valid)
+ */
+void * os_heap_realloc(os_heap_t * heap, void * ptr, size_t size);
+
+/**
+ * Get usable size of allocated block
+ *
+ * @param heap Heap Context
+ * @param ptr Previously allocated pointer
+ * @retval Usable size, can be bigger than requested
+ */
+size_t os_heap_block_size(os_heap_t * heap, void * ptr);
+
+/**
+ * Calls cb for every block of the heap
+ *
+ * @note Walks the whole heap, not meant for hot paths
+ *
+ * @param heap Heap Context
+ * @param cb Callback
+ * @param ctx User context passed to cb
+ */
+error_t os_heap_walk(os_heap_t * heap, os_heap_walk_cb_t cb, void * ctx);
+
+/**
+ * Collects heap statistics
+ *
+ * @note Counters are copied, block statistics require a full heap walk
+ *
+ * @param heap Heap Context
+ * @param stats Statistics
+ */
+error_t os_heap_stats(os_heap_t * heap, os_heap_stats_t * stats);
+
+/**
+ * Defragment the heap
  *
- * @note Use OS_HEAP_DEFRAG_ON_FREE to perform defrag after free
- *       (free may get slower)
+ * @note Both backends merge neighbouring free blocks on free, so this is a
+ *       no-op, kept for API compatibility
  *
  * @param heap Heap Context
  */
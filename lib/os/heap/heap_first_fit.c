@@ -0,0 +1,405 @@
+/** ========================================================================= *
+ *
+ * @file heap_first_fit.c
+ * @date 27-09-2024
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief First-fit heap backend
+ *
+ * Free blocks are kept in an explicit doubly linked list, allocation takes
+ * the first block that fits. Every block has a header and a footer
+ * (boundary tags) with a magic word, so free can validate the block and
+ * reach both physical neighbours in O(1), merging them immediately.
+ *
+ * Block layout:
+ *   [header][payload (size bytes)][footer]
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/heap/heap.h"
+#include "error/assertion.h"
+#include "log/log.h"
+#include <stdbool.h>
+#include <string.h>
+
+#if !USE_OS_HEAP_TLSF
+
+/* Defines ================================================================== */
+#define LOG_TAG heap
+
+/** Block header overhead (free list pointers are part of payload) */
+#define OS_HEAP_BLOCK_OVERHEAD  (offsetof(os_heap_block_t, next))
+
+/** Block footer overhead */
+#define OS_HEAP_BLOCK_FOOTER    (sizeof(os_heap_block_footer_t))
+
+/** Smallest block payload (must fit free list pointers) */
+#define OS_HEAP_BLOCK_SIZE_MIN  (sizeof(os_heap_block_t) - OS_HEAP_BLOCK_OVERHEAD)
+
+/** Smallest leading gap, that can be split off as a free block */
+#define OS_HEAP_BLOCK_GAP_MIN \
+  (OS_HEAP_BLOCK_OVERHEAD + OS_HEAP_BLOCK_SIZE_MIN + OS_HEAP_BLOCK_FOOTER)
+
+/* Macros =================================================================== */
+/** Align value up to power of 2 */
+#define OS_HEAP_ALIGN_UP_TO(__x, __align) \
+  (((size_t) (__x) + (__align) - 1) & ~((size_t) (__align) - 1))
+
+/** Align value up to pointer size */
+#define OS_HEAP_ALIGN_UP(__x) \
+  (((size_t) (__x) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/** Align value down to pointer size */
+#define OS_HEAP_ALIGN_DOWN(__x) \
+  ((size_t) (__x) & ~(sizeof(void *) - 1))
+
+/** First block of the heap */
+#define OS_HEAP_FIRST_BLOCK(__heap) \
+  ((os_heap_block_t *) OS_HEAP_ALIGN_UP((__heap)->start))
+
+/** End of the last block of the heap */
+#define OS_HEAP_END(__heap) \
+  ((uint8_t *) OS_HEAP_ALIGN_DOWN((__heap)->start + (__heap)->size))
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+__STATIC_INLINE void * os_heap_block_to_ptr(os_heap_block_t * block) {
+  return (uint8_t *) block + OS_HEAP_BLOCK_OVERHEAD;
+}
+
+__STATIC_INLINE os_heap_block_t * os_heap_block_from_ptr(void * ptr) {
+  return (os_heap_block_t *) ((uint8_t *) ptr - OS_HEAP_BLOCK_OVERHEAD);
+}
+
+__STATIC_INLINE os_heap_block_footer_t * os_heap_block_footer(os_heap_block_t * block) {
+  return (os_heap_block_footer_t *) ((uint8_t *) os_heap_block_to_ptr(block) + block->size);
+}
+
+__STATIC_INLINE os_heap_block_t * os_heap_block_next(os_heap_block_t * block) {
+  return (os_heap_block_t *) ((uint8_t *) os_heap_block_footer(block) + OS_HEAP_BLOCK_FOOTER);
+}
+
+/**
+ * Write header & footer of a block
+ */
+__STATIC_INLINE void os_heap_block_set(os_heap_block_t * block, size_t size, int state) {
+  block->magic = OS_HEAP_BLOCK_MAGIC;
+  block->state = state;
+  block->size = size;
+
+  os_heap_block_footer_t * footer = os_heap_block_footer(block);
+  footer->magic = OS_HEAP_BLOCK_MAGIC;
+  footer->size = size;
+}
+
+/**
+ * Check that header and footer of a block are intact
+ */
+__STATIC_INLINE bool os_heap_block_valid(os_heap_t * heap, os_heap_block_t * block) {
+  if ((uint8_t *) block < (uint8_t *) OS_HEAP_FIRST_BLOCK(heap)
+   || (uint8_t *) block + OS_HEAP_BLOCK_OVERHEAD > OS_HEAP_END(heap)
+   || (size_t) block & (sizeof(void *) - 1)
+   || block->magic != OS_HEAP_BLOCK_MAGIC
+   || block->size > (size_t) (OS_HEAP_END(heap) - (uint8_t *) block)) {
+    return false;
+  }
+
+  os_heap_block_footer_t * footer = os_heap_block_footer(block);
+
+  return (uint8_t *) footer + OS_HEAP_BLOCK_FOOTER <= OS_HEAP_END(heap)
+      && footer->magic == OS_HEAP_BLOCK_MAGIC
+      && footer->size == block->size;
+}
+
+/**
+ * Previous physical block, or NULL if block is first in the heap
+ */
+__STATIC_INLINE os_heap_block_t * os_heap_block_prev(os_heap_t * heap, os_heap_block_t * block) {
+  if (block == OS_HEAP_FIRST_BLOCK(heap)) {
+    return NULL;
+  }
+
+  os_heap_block_footer_t * footer = (os_heap_block_footer_t *) ((uint8_t *) block - OS_HEAP_BLOCK_FOOTER);
+
+  if (footer->magic != OS_HEAP_BLOCK_MAGIC) {
+    return NULL;
+  }
+
+  return (os_heap_block_t *) ((uint8_t *) footer - footer->size - OS_HEAP_BLOCK_OVERHEAD);
+}
+
+__STATIC_INLINE void os_heap_list_insert(os_heap_t * heap, os_heap_block_t * block) {
+  block->prev = NULL;
+  block->next = heap->free_list;
+
+  if (heap->free_list) {
+    heap->free_list->prev = block;
+  }
+
+  heap->free_list = block;
+}
+
+__STATIC_INLINE void os_heap_list_remove(os_heap_t * heap, os_heap_block_t * block) {
+  if (block->prev) {
+    block->prev->next = block->next;
+  } else {
+    heap->free_list = block->next;
+  }
+
+  if (block->next) {
+    block->next->prev = block->prev;
+  }
+}
+
+/**
+ * Merge block with next physical block (block absorbs next)
+ */
+__STATIC_INLINE void os_heap_block_absorb(os_heap_block_t * block, os_heap_block_t * next) {
+  os_heap_block_set(
+    block,
+    block->size + OS_HEAP_BLOCK_FOOTER + OS_HEAP_BLOCK_OVERHEAD + next->size,
+    block->state
+  );
+}
+
+/**
+ * Marks block (already removed from free list) as used, returning the tail
+ * to free list if it's big enough
+ */
+__STATIC_INLINE void os_heap_block_use(os_heap_t * heap, os_heap_block_t * block, size_t size) {
+  if (block->size >= size + OS_HEAP_BLOCK_FOOTER + OS_HEAP_BLOCK_OVERHEAD + OS_HEAP_BLOCK_SIZE_MIN) {
+    size_t remaining = block->size - size - OS_HEAP_BLOCK_FOOTER - OS_HEAP_BLOCK_OVERHEAD;
+
+    os_heap_block_set(block, size, OS_HEAP_BLOCK_USED);
+
+    os_heap_block_t * next = os_heap_block_next(block);
+    os_heap_block_set(next, remaining, OS_HEAP_BLOCK_FREE);
+    os_heap_list_insert(heap, next);
+  } else {
+    /* Not enough space to split, take the whole block */
+    block->state = OS_HEAP_BLOCK_USED;
+  }
+}
+
+/* Shared functions ========================================================= */
+error_t os_heap_backend_init(os_heap_t * heap) {
+  os_heap_block_t * block = OS_HEAP_FIRST_BLOCK(heap);
+  uint8_t * end = OS_HEAP_END(heap);
+
+  ASSERT_RETURN(
+    end > (uint8_t *) block
+      && (size_t) (end - (uint8_t *) block) >= OS_HEAP_BLOCK_OVERHEAD + OS_HEAP_BLOCK_SIZE_MIN + OS_HEAP_BLOCK_FOOTER,
+    E_NOMEM
+  );
+
+  os_heap_block_set(
+    block,
+    (size_t) (end - (uint8_t *) block) - OS_HEAP_BLOCK_OVERHEAD - OS_HEAP_BLOCK_FOOTER,
+    OS_HEAP_BLOCK_FREE
+  );
+
+  heap->free_list = NULL;
+  os_heap_list_insert(heap, block);
+
+  return E_OK;
+}
+
+void * os_heap_backend_alloc(os_heap_t * heap, size_t size) {
+  /* Keep block headers aligned */
+  size = OS_HEAP_ALIGN_UP(size);
+
+  if (size < OS_HEAP_BLOCK_SIZE_MIN) {
+    size = OS_HEAP_BLOCK_SIZE_MIN;
+  }
+
+  os_heap_block_t * block = heap->free_list;
+
+  while (block && block->size < size) {
+    block = block->next;
+  }
+
+  if (!block) {
+    log_debug("os_heap_alloc: no memory left");
+    return NULL;
+  }
+
+  os_heap_list_remove(heap, block);
+  os_heap_block_use(heap, block, size);
+
+  log_debug("os_heap_alloc(%u): block=%p size=%u", size, block, block->size);
+
+  return os_heap_block_to_ptr(block);
+}
+
+void * os_heap_backend_alloc_aligned(os_heap_t * heap, size_t size, size_t align) {
+  if (align <= sizeof(void *)) {
+    return os_heap_backend_alloc(heap, size);
+  }
+
+  size = OS_HEAP_ALIGN_UP(size);
+
+  if (size < OS_HEAP_BLOCK_SIZE_MIN) {
+    size = OS_HEAP_BLOCK_SIZE_MIN;
+  }
+
+  os_heap_block_t * block = heap->free_list;
+  size_t gap = 0;
+
+  for (; block; block = block->next) {
+    uint8_t * ptr = os_heap_block_to_ptr(block);
+    uint8_t * aligned = (uint8_t *) OS_HEAP_ALIGN_UP_TO(ptr, align);
+
+    /* Leading gap must be big enough to become a free block on its own */
+    if (aligned != ptr && (size_t) (aligned - ptr) < OS_HEAP_BLOCK_GAP_MIN) {
+      aligned = (uint8_t *) OS_HEAP_ALIGN_UP_TO(ptr + OS_HEAP_BLOCK_GAP_MIN, align);
+    }
+
+    gap = (size_t) (aligned - ptr);
+
+    if (block->size >= gap + size) {
+      break;
+    }
+  }
+
+  if (!block) {
+    log_debug("os_heap_alloc_aligned: no memory left");
+    return NULL;
+  }
+
+  os_heap_list_remove(heap, block);
+
+  if (gap) {
+    os_heap_block_t * aligned = (os_heap_block_t *) ((uint8_t *) block + gap);
+    size_t aligned_size = block->size - gap;
+
+    os_heap_block_set(block, gap - OS_HEAP_BLOCK_OVERHEAD - OS_HEAP_BLOCK_FOOTER, OS_HEAP_BLOCK_FREE);
+    os_heap_list_insert(heap, block);
+
+    block = aligned;
+    os_heap_block_set(block, aligned_size, OS_HEAP_BLOCK_FREE);
+  }
+
+  os_heap_block_use(heap, block, size);
+
+  log_debug("os_heap_alloc_aligned(%u, %u): block=%p size=%u", size, align, block, block->size);
+
+  return os_heap_block_to_ptr(block);
+}
+
+error_t os_heap_backend_free(os_heap_t * heap, void * ptr) {
+  os_heap_block_t * block = os_heap_block_from_ptr(ptr);
+
+  if (!os_heap_block_valid(heap, block)) {
+    log_error("os_heap_free(%p): bad block", ptr);
+    return E_INVAL;
+  }
+
+  if (block->state != OS_HEAP_BLOCK_USED) {
+    log_error("os_heap_free(%p): double free", ptr);
+    return E_INVAL;
+  }
+
+  log_debug("os_heap_free(%p): block=%p size=%u", ptr, block, block->size);
+
+  block->state = OS_HEAP_BLOCK_FREE;
+
+  os_heap_block_t * next = os_heap_block_next(block);
+
+  if ((uint8_t *) next < OS_HEAP_END(heap) && next->magic == OS_HEAP_BLOCK_MAGIC
+      && next->state == OS_HEAP_BLOCK_FREE) {
+    os_heap_list_remove(heap, next);
+    os_heap_block_absorb(block, next);
+  }
+
+  os_heap_block_t * prev = os_heap_block_prev(heap, block);
+
+  if (prev && prev->magic == OS_HEAP_BLOCK_MAGIC && prev->state == OS_HEAP_BLOCK_FREE) {
+    os_heap_list_remove(heap, prev);
+    os_heap_block_absorb(prev, block);
+    block = prev;
+  }
+
+  os_heap_list_insert(heap, block);
+
+  return E_OK;
+}
+
+bool os_heap_backend_resize(os_heap_t * heap, void * ptr, size_t size) {
+  os_heap_block_t * block = os_heap_block_from_ptr(ptr);
+
+  if (!os_heap_block_valid(heap, block) || block->state != OS_HEAP_BLOCK_USED) {
+    log_error("os_heap_resize(%p): bad block", ptr);
+    return false;
+  }
+
+  size = OS_HEAP_ALIGN_UP(size);
+
+  if (size < OS_HEAP_BLOCK_SIZE_MIN) {
+    size = OS_HEAP_BLOCK_SIZE_MIN;
+  }
+
+  os_heap_block_t * next = os_heap_block_next(block);
+
+  if (size > block->size) {
+    if ((uint8_t *) next >= OS_HEAP_END(heap) || next->magic != OS_HEAP_BLOCK_MAGIC
+        || next->state != OS_HEAP_BLOCK_FREE
+        || block->size + OS_HEAP_BLOCK_FOOTER + OS_HEAP_BLOCK_OVERHEAD + next->size < size) {
+      return false;
+    }
+
+    os_heap_list_remove(heap, next);
+    os_heap_block_absorb(block, next);
+  }
+
+  os_heap_block_use(heap, block, size);
+
+  /* Split off tail may border a free block, merge them */
+  os_heap_block_t * tail = os_heap_block_next(block);
+
+  if ((uint8_t *) tail < OS_HEAP_END(heap) && tail->state == OS_HEAP_BLOCK_FREE) {
+    next = os_heap_block_next(tail);
+
+    if ((uint8_t *) next < OS_HEAP_END(heap) && next->magic == OS_HEAP_BLOCK_MAGIC
+        && next->state == OS_HEAP_BLOCK_FREE) {
+      os_heap_list_remove(heap, next);
+      os_heap_block_absorb(tail, next);
+    }
+  }
+
+  log_debug("os_heap_resize(%p, %u): size=%u", ptr, size, block->size);
+
+  return true;
+}
+
+size_t os_heap_backend_block_size(os_heap_t * heap, void * ptr) {
+  os_heap_block_t * block = os_heap_block_from_ptr(ptr);
+  return os_heap_block_valid(heap, block) ? block->size : 0;
+}
+
+error_t os_heap_backend_walk(os_heap_t * heap, os_heap_walk_cb_t cb, void * ctx) {
+  uint8_t * end = OS_HEAP_END(heap);
+
+  for (os_heap_block_t * block = OS_HEAP_FIRST_BLOCK(heap);
+       (uint8_t *) block + OS_HEAP_BLOCK_OVERHEAD <= end;
+       block = os_heap_block_next(block)) {
+    if (!os_heap_block_valid(heap, block)) {
+      log_error("os_heap_walk: bad block %p", block);
+      return E_CORRUPT;
+    }
+
+    cb(ctx, os_heap_block_to_ptr(block), block->size, block->state == OS_HEAP_BLOCK_USED);
+  }
+
+  return E_OK;
+}
+
+error_t os_heap_backend_defrag(os_heap_t * heap) {
+  (void) heap;
+  return E_OK;
+}
+
+#endif
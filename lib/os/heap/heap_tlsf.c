@@ -0,0 +1,583 @@
+/** ========================================================================= *
+ *
+ * @file heap_tlsf.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Two-Level Segregated Fit heap backend
+ *
+ * Free blocks are kept in segregated lists indexed by two levels:
+ *   - First level  - power of 2 size class (fls of block size)
+ *   - Second level - linear subdivision of first level class
+ *
+ * Non-empty lists are tracked in bitmaps, so finding a suitable block is a
+ * couple of find-first-set operations, making alloc and free O(1).
+ * Neighbouring free blocks are merged on free.
+ *
+ * Memory layout:
+ *   [control][block][block]...[sentinel]
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/heap/heap.h"
+#include "error/assertion.h"
+#include "log/log.h"
+#include <stdbool.h>
+#include <string.h>
+
+#if USE_OS_HEAP_TLSF
+
+/* Defines ================================================================== */
+#define LOG_TAG heap
+
+/** Second level subdivisions count */
+#define TLSF_SL_COUNT         (1U << OS_HEAP_TLSF_SL_LOG2)
+
+/** log2 of alignment */
+#if OS_HEAP_TLSF_ALIGN == 4
+#define TLSF_ALIGN_LOG2       2
+#elif OS_HEAP_TLSF_ALIGN == 8
+#define TLSF_ALIGN_LOG2       3
+#elif OS_HEAP_TLSF_ALIGN == 16
+#define TLSF_ALIGN_LOG2       4
+#else
+#error "Unsupported OS_HEAP_TLSF_ALIGN"
+#endif
+
+/** First level index of first non-linear class */
+#define TLSF_FL_SHIFT         (OS_HEAP_TLSF_SL_LOG2 + TLSF_ALIGN_LOG2)
+
+/** Blocks smaller than that are all stored in first level class 0 */
+#define TLSF_SMALL_BLOCK      (1U << TLSF_FL_SHIFT)
+
+/** First level classes count */
+#define TLSF_FL_COUNT         (OS_HEAP_TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+
+/** Block header overhead (prev_phys & size) */
+#define TLSF_BLOCK_OVERHEAD   (offsetof(os_heap_tlsf_block_t, next_free))
+
+/** Smallest block payload (must fit free list pointers) */
+#define TLSF_BLOCK_SIZE_MIN   \
+  TLSF_ALIGN_UP(sizeof(os_heap_tlsf_block_t) - TLSF_BLOCK_OVERHEAD)
+
+/** Biggest block payload */
+#define TLSF_BLOCK_SIZE_MAX   \
+  (((size_t) 1 << OS_HEAP_TLSF_FL_MAX) - OS_HEAP_TLSF_ALIGN)
+
+/** Block is free flag (stored in lower bits of size) */
+#define TLSF_BLOCK_FREE       (1U << 0)
+
+/** Block flags mask */
+#define TLSF_BLOCK_FLAGS      (OS_HEAP_TLSF_ALIGN - 1)
+
+/* Macros =================================================================== */
+/** Align value up to OS_HEAP_TLSF_ALIGN */
+#define TLSF_ALIGN_UP(__x) \
+  (((__x) + (OS_HEAP_TLSF_ALIGN - 1)) & ~((size_t) OS_HEAP_TLSF_ALIGN - 1))
+
+/** Get control block of a heap (heap start may be unaligned) */
+#define TLSF_CONTROL(__heap) \
+  ((os_heap_tlsf_control_t *) TLSF_ALIGN_UP((size_t) (__heap)->start))
+
+/** Get first block of a heap, right after control block */
+#define TLSF_FIRST_BLOCK(__heap) \
+  ((os_heap_tlsf_block_t *) TLSF_ALIGN_UP((size_t) TLSF_CONTROL(__heap) + sizeof(os_heap_tlsf_control_t)))
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * TLSF Block Header
+ *
+ * @note next_free & prev_free overlap with payload and are only valid if
+ *       the block is free
+ */
+typedef struct os_heap_tlsf_block_s {
+  struct os_heap_tlsf_block_s * prev_phys;  /** Previous physical block */
+  size_t size;                              /** Payload size | flags */
+  struct os_heap_tlsf_block_s * next_free;  /** Next free block in list */
+  struct os_heap_tlsf_block_s * prev_free;  /** Prev free block in list */
+} os_heap_tlsf_block_t;
+
+/**
+ * TLSF Control Block
+ */
+typedef struct {
+  uint32_t fl_bitmap;                                        /** Non-empty first level classes */
+  uint32_t sl_bitmap[TLSF_FL_COUNT];                         /** Non-empty second level lists */
+  os_heap_tlsf_block_t * blocks[TLSF_FL_COUNT][TLSF_SL_COUNT]; /** Free lists */
+} os_heap_tlsf_control_t;
+
+_Static_assert(OS_HEAP_TLSF_SL_LOG2 <= 5, "OS_HEAP_TLSF_SL_LOG2 must be <= 5");
+_Static_assert(OS_HEAP_TLSF_FL_MAX <= 31, "OS_HEAP_TLSF_FL_MAX must be <= 31");
+_Static_assert(OS_HEAP_TLSF_ALIGN >= sizeof(void *),
+               "OS_HEAP_TLSF_ALIGN must be at least pointer size");
+_Static_assert(offsetof(os_heap_tlsf_block_t, next_free) % OS_HEAP_TLSF_ALIGN == 0,
+               "OS_HEAP_TLSF_ALIGN must divide block header size");
+
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Index of most significant set bit (x must be non-zero)
+ */
+__STATIC_INLINE int tlsf_fls(size_t x) {
+  return 31 - __builtin_clz((uint32_t) x);
+}
+
+/**
+ * Index of least significant set bit (x must be non-zero)
+ */
+__STATIC_INLINE int tlsf_ffs(uint32_t x) {
+  return __builtin_ctz(x);
+}
+
+__STATIC_INLINE size_t tlsf_block_size(os_heap_tlsf_block_t * block) {
+  return block->size & ~(size_t) TLSF_BLOCK_FLAGS;
+}
+
+__STATIC_INLINE void tlsf_block_set_size(os_heap_tlsf_block_t * block, size_t size) {
+  block->size = size | (block->size & TLSF_BLOCK_FLAGS);
+}
+
+__STATIC_INLINE bool tlsf_block_is_free(os_heap_tlsf_block_t * block) {
+  return block->size & TLSF_BLOCK_FREE;
+}
+
+__STATIC_INLINE void tlsf_block_set_free(os_heap_tlsf_block_t * block, bool free) {
+  block->size = free ? (block->size | TLSF_BLOCK_FREE) : (block->size & ~(size_t) TLSF_BLOCK_FREE);
+}
+
+__STATIC_INLINE void * tlsf_block_to_ptr(os_heap_tlsf_block_t * block) {
+  return (uint8_t *) block + TLSF_BLOCK_OVERHEAD;
+}
+
+__STATIC_INLINE os_heap_tlsf_block_t * tlsf_block_from_ptr(void * ptr) {
+  return (os_heap_tlsf_block_t *) ((uint8_t *) ptr - TLSF_BLOCK_OVERHEAD);
+}
+
+__STATIC_INLINE os_heap_tlsf_block_t * tlsf_block_next(os_heap_tlsf_block_t * block) {
+  return (os_heap_tlsf_block_t *) ((uint8_t *) tlsf_block_to_ptr(block) + tlsf_block_size(block));
+}
+
+/**
+ * Map block size to free list indexes, used for insertion
+ */
+__STATIC_INLINE void tlsf_mapping_insert(size_t size, int * fl, int * sl) {
+  if (size < TLSF_SMALL_BLOCK) {
+    *fl = 0;
+    *sl = (int) (size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+  } else {
+    int msb = tlsf_fls(size);
+    *sl = (int) ((size >> (msb - OS_HEAP_TLSF_SL_LOG2)) ^ TLSF_SL_COUNT);
+    *fl = msb - (TLSF_FL_SHIFT - 1);
+  }
+}
+
+/**
+ * Map requested size to free list indexes, used for search
+ * Rounds size up to the next list, so any block in it fits the request
+ */
+__STATIC_INLINE void tlsf_mapping_search(size_t size, int * fl, int * sl) {
+  if (size >= TLSF_SMALL_BLOCK) {
+    size += ((size_t) 1 << (tlsf_fls(size) - OS_HEAP_TLSF_SL_LOG2)) - 1;
+  }
+  tlsf_mapping_insert(size, fl, sl);
+}
+
+__STATIC_INLINE os_heap_tlsf_block_t * tlsf_find_suitable(
+    os_heap_tlsf_control_t * control, int * fl, int * sl
+) {
+  if (*fl >= (int) TLSF_FL_COUNT) {
+    return NULL;
+  }
+
+  uint32_t sl_map = control->sl_bitmap[*fl] & (~0U << *sl);
+
+  if (!sl_map) {
+    uint32_t fl_map = *fl + 1 < 32 ? control->fl_bitmap & (~0U << (*fl + 1)) : 0;
+
+    if (!fl_map) {
+      return NULL;
+    }
+
+    *fl = tlsf_ffs(fl_map);
+    sl_map = control->sl_bitmap[*fl];
+  }
+
+  *sl = tlsf_ffs(sl_map);
+
+  return control->blocks[*fl][*sl];
+}
+
+__STATIC_INLINE void tlsf_remove_free(
+    os_heap_tlsf_control_t * control, os_heap_tlsf_block_t * block, int fl, int sl
+) {
+  if (block->next_free) {
+    block->next_free->prev_free = block->prev_free;
+  }
+
+  if (block->prev_free) {
+    block->prev_free->next_free = block->next_free;
+  }
+
+  if (control->blocks[fl][sl] == block) {
+    control->blocks[fl][sl] = block->next_free;
+
+    if (!block->next_free) {
+      control->sl_bitmap[fl] &= ~(1U << sl);
+
+      if (!control->sl_bitmap[fl]) {
+        control->fl_bitmap &= ~(1U << fl);
+      }
+    }
+  }
+}
+
+__STATIC_INLINE void tlsf_insert_free(
+    os_heap_tlsf_control_t * control, os_heap_tlsf_block_t * block, int fl, int sl
+) {
+  os_heap_tlsf_block_t * head = control->blocks[fl][sl];
+
+  block->next_free = head;
+  block->prev_free = NULL;
+
+  if (head) {
+    head->prev_free = block;
+  }
+
+  control->blocks[fl][sl] = block;
+  control->fl_bitmap |= 1U << fl;
+  control->sl_bitmap[fl] |= 1U << sl;
+}
+
+__STATIC_INLINE void tlsf_block_remove(os_heap_tlsf_control_t * control, os_heap_tlsf_block_t * block) {
+  int fl, sl;
+  tlsf_mapping_insert(tlsf_block_size(block), &fl, &sl);
+  tlsf_remove_free(control, block, fl, sl);
+}
+
+__STATIC_INLINE void tlsf_block_insert(os_heap_tlsf_control_t * control, os_heap_tlsf_block_t * block) {
+  int fl, sl;
+  tlsf_mapping_insert(tlsf_block_size(block), &fl, &sl);
+  tlsf_insert_free(control, block, fl, sl);
+}
+
+/**
+ * Split block to size bytes, returning remainder to free lists
+ */
+__STATIC_INLINE void tlsf_block_trim(
+    os_heap_tlsf_control_t * control, os_heap_tlsf_block_t * block, size_t size
+) {
+  size_t block_size = tlsf_block_size(block);
+
+  if (block_size < size + TLSF_BLOCK_OVERHEAD + TLSF_BLOCK_SIZE_MIN) {
+    return;
+  }
+
+  os_heap_tlsf_block_t * remaining =
+      (os_heap_tlsf_block_t *) ((uint8_t *) tlsf_block_to_ptr(block) + size);
+
+  remaining->size = (block_size - size - TLSF_BLOCK_OVERHEAD) | TLSF_BLOCK_FREE;
+  remaining->prev_phys = block;
+  tlsf_block_next(remaining)->prev_phys = remaining;
+
+  tlsf_block_set_size(block, size);
+
+  tlsf_block_insert(control, remaining);
+}
+
+/**
+ * Merge block with next physical block (block absorbs next)
+ */
+__STATIC_INLINE os_heap_tlsf_block_t * tlsf_block_absorb(
+    os_heap_tlsf_block_t * block, os_heap_tlsf_block_t * next
+) {
+  tlsf_block_set_size(block, tlsf_block_size(block) + tlsf_block_size(next) + TLSF_BLOCK_OVERHEAD);
+  tlsf_block_next(block)->prev_phys = block;
+  return block;
+}
+
+__STATIC_INLINE bool tlsf_block_can_absorb(os_heap_tlsf_block_t * block, os_heap_tlsf_block_t * next) {
+  return tlsf_block_size(block) + tlsf_block_size(next) + TLSF_BLOCK_OVERHEAD <= TLSF_BLOCK_SIZE_MAX;
+}
+
+__STATIC_INLINE bool tlsf_ptr_valid(os_heap_t * heap, void * ptr) {
+  uint8_t * first = (uint8_t *) TLSF_FIRST_BLOCK(heap);
+
+  if ((uint8_t *) ptr < first + TLSF_BLOCK_OVERHEAD
+   || (uint8_t *) ptr >= heap->start + heap->size
+   || ((size_t) ptr & (OS_HEAP_TLSF_ALIGN - 1))) {
+    return false;
+  }
+
+  return true;
+}
+
+/* Shared functions ========================================================= */
+error_t os_heap_backend_init(os_heap_t * heap) {
+  os_heap_tlsf_control_t * control = TLSF_CONTROL(heap);
+
+  heap->free_list = NULL;
+
+  uint8_t * start = (uint8_t *) TLSF_FIRST_BLOCK(heap);
+  uint8_t * end = (uint8_t *) (((size_t) heap->start + heap->size) & ~((size_t) OS_HEAP_TLSF_ALIGN - 1));
+
+  ASSERT_RETURN(
+    end > start && (size_t) (end - start) >= 2 * TLSF_BLOCK_OVERHEAD + TLSF_BLOCK_SIZE_MIN,
+    E_NOMEM
+  );
+
+  memset(control, 0, sizeof(os_heap_tlsf_control_t));
+
+  /* Leave space for sentinel (size = 0, used) at the end */
+  end -= TLSF_BLOCK_OVERHEAD;
+
+  os_heap_tlsf_block_t * prev = NULL;
+  os_heap_tlsf_block_t * block = (os_heap_tlsf_block_t *) start;
+
+  /* Region may be bigger than maximum block size, split it */
+  while ((size_t) (end - (uint8_t *) block) >= TLSF_BLOCK_OVERHEAD + TLSF_BLOCK_SIZE_MIN) {
+    size_t size = (size_t) (end - (uint8_t *) block) - TLSF_BLOCK_OVERHEAD;
+
+    if (size > TLSF_BLOCK_SIZE_MAX) {
+      size = TLSF_BLOCK_SIZE_MAX;
+    }
+
+    block->prev_phys = prev;
+    block->size = size | TLSF_BLOCK_FREE;
+
+    tlsf_block_insert(control, block);
+
+    prev = block;
+    block = tlsf_block_next(block);
+  }
+
+  /* Leftover (if any) is too small for a free block, append it to sentinel */
+  block->prev_phys = prev;
+  block->size = 0;
+
+  return E_OK;
+}
+
+void * os_heap_backend_alloc(os_heap_t * heap, size_t size) {
+  os_heap_tlsf_control_t * control = TLSF_CONTROL(heap);
+
+  if (!size || size > TLSF_BLOCK_SIZE_MAX) {
+    return NULL;
+  }
+
+  size = TLSF_ALIGN_UP(size);
+
+  if (size < TLSF_BLOCK_SIZE_MIN) {
+    size = TLSF_BLOCK_SIZE_MIN;
+  }
+
+  int fl, sl;
+  tlsf_mapping_search(size, &fl, &sl);
+
+  os_heap_tlsf_block_t * block = tlsf_find_suitable(control, &fl, &sl);
+
+  if (!block) {
+    log_debug("os_heap_alloc: no memory left");
+    return NULL;
+  }
+
+  tlsf_remove_free(control, block, fl, sl);
+  tlsf_block_set_free(block, false);
+  tlsf_block_trim(control, block, size);
+
+  log_debug("os_heap_alloc(%u): block=%p size=%u", size, block, tlsf_block_size(block));
+
+  return tlsf_block_to_ptr(block);
+}
+
+void * os_heap_backend_alloc_aligned(os_heap_t * heap, size_t size, size_t align) {
+  os_heap_tlsf_control_t * control = TLSF_CONTROL(heap);
+
+  if (align <= OS_HEAP_TLSF_ALIGN) {
+    return os_heap_backend_alloc(heap, size);
+  }
+
+  size = TLSF_ALIGN_UP(size);
+
+  if (size < TLSF_BLOCK_SIZE_MIN) {
+    size = TLSF_BLOCK_SIZE_MIN;
+  }
+
+  /* Worst case - aligned pointer is behind a minimal free block and align */
+  size_t gap_min = TLSF_BLOCK_OVERHEAD + TLSF_BLOCK_SIZE_MIN;
+  size_t search = size + align + gap_min;
+
+  if (search > TLSF_BLOCK_SIZE_MAX) {
+    return NULL;
+  }
+
+  int fl, sl;
+  tlsf_mapping_search(search, &fl, &sl);
+
+  os_heap_tlsf_block_t * block = tlsf_find_suitable(control, &fl, &sl);
+
+  if (!block) {
+    log_debug("os_heap_alloc_aligned: no memory left");
+    return NULL;
+  }
+
+  tlsf_remove_free(control, block, fl, sl);
+
+  uint8_t * ptr = tlsf_block_to_ptr(block);
+  size_t aligned = ((size_t) ptr + align - 1) & ~(align - 1);
+
+  /* Leading gap must be big enough to become a free block on its own */
+  if (aligned != (size_t) ptr && aligned - (size_t) ptr < gap_min) {
+    aligned = ((size_t) ptr + gap_min + align - 1) & ~(align - 1);
+  }
+
+  size_t gap = aligned - (size_t) ptr;
+
+  if (gap) {
+    os_heap_tlsf_block_t * next = tlsf_block_next(block);
+    os_heap_tlsf_block_t * used = (os_heap_tlsf_block_t *) ((uint8_t *) block + gap);
+
+    used->size = tlsf_block_size(block) - gap;
+    used->prev_phys = block;
+    next->prev_phys = used;
+
+    block->size = (gap - TLSF_BLOCK_OVERHEAD) | TLSF_BLOCK_FREE;
+    tlsf_block_insert(control, block);
+
+    block = used;
+  }
+
+  tlsf_block_set_free(block, false);
+  tlsf_block_trim(control, block, size);
+
+  log_debug("os_heap_alloc_aligned(%u, %u): block=%p size=%u", size, align, block, tlsf_block_size(block));
+
+  return tlsf_block_to_ptr(block);
+}
+
+error_t os_heap_backend_free(os_heap_t * heap, void * ptr) {
+  os_heap_tlsf_control_t * control = TLSF_CONTROL(heap);
+
+  if (!tlsf_ptr_valid(heap, ptr)) {
+    log_error("os_heap_free(%p): not in heap", ptr);
+    return E_INVAL;
+  }
+
+  os_heap_tlsf_block_t * block = tlsf_block_from_ptr(ptr);
+  os_heap_tlsf_block_t * next = tlsf_block_next(block);
+
+  if (tlsf_block_is_free(block) || next->prev_phys != block) {
+    log_error("os_heap_free(%p): bad block", ptr);
+    return E_INVAL;
+  }
+
+  log_debug("os_heap_free(%p): block=%p size=%u", ptr, block, tlsf_block_size(block));
+
+  tlsf_block_set_free(block, true);
+
+  os_heap_tlsf_block_t * prev = block->prev_phys;
+
+  if (prev && tlsf_block_is_free(prev) && tlsf_block_can_absorb(prev, block)) {
+    tlsf_block_remove(control, prev);
+    block = tlsf_block_absorb(prev, block);
+  }
+
+  if (tlsf_block_is_free(next) && tlsf_block_can_absorb(block, next)) {
+    tlsf_block_remove(control, next);
+    block = tlsf_block_absorb(block, next);
+  }
+
+  tlsf_block_insert(control, block);
+
+  return E_OK;
+}
+
+bool os_heap_backend_resize(os_heap_t * heap, void * ptr, size_t size) {
+  os_heap_tlsf_control_t * control = TLSF_CONTROL(heap);
+
+  if (!tlsf_ptr_valid(heap, ptr)) {
+    log_error("os_heap_resize(%p): not in heap", ptr);
+    return false;
+  }
+
+  os_heap_tlsf_block_t * block = tlsf_block_from_ptr(ptr);
+  os_heap_tlsf_block_t * next = tlsf_block_next(block);
+
+  if (tlsf_block_is_free(block) || next->prev_phys != block) {
+    log_error("os_heap_resize(%p): bad block", ptr);
+    return false;
+  }
+
+  if (size > TLSF_BLOCK_SIZE_MAX) {
+    return false;
+  }
+
+  size = TLSF_ALIGN_UP(size);
+
+  if (size < TLSF_BLOCK_SIZE_MIN) {
+    size = TLSF_BLOCK_SIZE_MIN;
+  }
+
+  if (size > tlsf_block_size(block)) {
+    if (!tlsf_block_is_free(next) || !tlsf_block_can_absorb(block, next)
+        || tlsf_block_size(block) + TLSF_BLOCK_OVERHEAD + tlsf_block_size(next) < size) {
+      return false;
+    }
+
+    tlsf_block_remove(control, next);
+    tlsf_block_absorb(block, next);
+  }
+
+  tlsf_block_trim(control, block, size);
+
+  /* Split off tail may border a free block, merge them */
+  os_heap_tlsf_block_t * tail = tlsf_block_next(block);
+
+  if (tlsf_block_is_free(tail)) {
+    next = tlsf_block_next(tail);
+
+    if (tlsf_block_is_free(next) && tlsf_block_can_absorb(tail, next)) {
+      tlsf_block_remove(control, tail);
+      tlsf_block_remove(control, next);
+      tlsf_block_insert(control, tlsf_block_absorb(tail, next));
+    }
+  }
+
+  log_debug("os_heap_resize(%p, %u): size=%u", ptr, size, tlsf_block_size(block));
+
+  return true;
+}
+
+size_t os_heap_backend_block_size(os_heap_t * heap, void * ptr) {
+  (void) heap;
+  return tlsf_block_size(tlsf_block_from_ptr(ptr));
+}
+
+error_t os_heap_backend_walk(os_heap_t * heap, os_heap_walk_cb_t cb, void * ctx) {
+  os_heap_tlsf_block_t * block = TLSF_FIRST_BLOCK(heap);
+
+  /* Sentinel is the only block with zero size */
+  while (tlsf_block_size(block)) {
+    os_heap_tlsf_block_t * next = tlsf_block_next(block);
+
+    if ((uint8_t *) next >= heap->start + heap->size || next->prev_phys != block) {
+      log_error("os_heap_walk: bad block %p", block);
+      return E_CORRUPT;
+    }
+
+    cb(ctx, tlsf_block_to_ptr(block), tlsf_block_size(block), !tlsf_block_is_free(block));
+
+    block = next;
+  }
+
+  return E_OK;
+}
+
+error_t os_heap_backend_defrag(os_heap_t * heap) {
+  (void) heap;
+  return E_OK;
+}
+
+#endif
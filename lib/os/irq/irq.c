@@ -27,6 +27,14 @@ void os_irq_disable(uint8_t irq) {
   os_irq_disable_port(irq);
 }
 
+uint32_t os_irq_save(void) {
+  return os_irq_save_port();
+}
+
+void os_irq_restore(uint32_t state) {
+  os_irq_restore_port(state);
+}
+
 void os_irq_set_prio(uint8_t irq, uint8_t prio) {
   os_irq_set_prio_port(irq, prio);
 }
@@ -43,6 +51,17 @@ __WEAK void os_irq_disable_port(uint8_t irq) {
   log_warn("os_irq_enable is using weak stub");
 }
 
+__WEAK uint32_t os_irq_save_port(void) {
+  os_irq_disable_port(OS_IRQ_ALL);
+  return 1;
+}
+
+__WEAK void os_irq_restore_port(uint32_t state) {
+  if (state) {
+    os_irq_enable_port(OS_IRQ_ALL);
+  }
+}
+
 __WEAK void os_irq_set_prio_port(uint8_t irq, uint8_t prio) {
   log_warn("os_irq_set_prio is using weak stub");
 }
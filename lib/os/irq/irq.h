@@ -35,6 +35,18 @@ void os_irq_enable(uint8_t irq);
  */
 void os_irq_disable(uint8_t irq);
 
+/**
+ * Disables all IRQs, returns previous mask state
+ *
+ * Unlike os_irq_disable/os_irq_enable pair, can be nested and used from IRQ
+ */
+uint32_t os_irq_save(void);
+
+/**
+ * Restores mask state, previously returned by os_irq_save
+ */
+void os_irq_restore(uint32_t state);
+
 /**
  * Sets priority to IRQ
  */
@@ -59,6 +71,20 @@ void os_irq_enable_port(uint8_t irq);
  */
 void os_irq_disable_port(uint8_t irq);
 
+/**
+ * Port of os_irq_save, BSP defined
+ *
+ * Not required, has a stub implementation, that doesn't nest
+ */
+uint32_t os_irq_save_port(void);
+
+/**
+ * Port of os_irq_restore, BSP defined
+ *
+ * Not required, has a stub implementation, that doesn't nest
+ */
+void os_irq_restore_port(uint32_t state);
+
 /**
  * Port of os_irq_set_prio, BSP defined
  *
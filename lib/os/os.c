@@ -128,6 +128,11 @@ typedef struct {
 
   /** Task runs within a cycle */
   uint32_t runs;
+
+#if USE_OS_SCHED_TABLE
+  /** Schedule table for cyclic executive, NULL for round-robin */
+  os_sched_table_t * sched_table;
+#endif
 } os_t;
 
 /* Variables ================================================================ */
@@ -166,6 +171,116 @@ __STATIC_INLINE void os_task_next(void) {
   }
 }
 
+#if USE_OS_SCHED_TABLE
+/**
+ * Runs task once from cyclic executive (until it yields back)
+ *
+ * Initializes task on first activation, skips task if it's not ready
+ *
+ * @param task Task handle
+ */
+static void os_sched_table_run_task(os_task_t * task) {
+  os.task.current = task;
+
+  // Initialize task, if it is not
+  if (task->state == OS_TASK_STATE_INIT) {
+    log_info("Init task %p '%s'", task, task->name);
+    task->state = OS_TASK_STATE_READY;
+
+    // Next call to os_schedule will return here
+    if (setjmp(os.ctx.buf)) {
+      return;
+    }
+
+    os_task_stack_init(task);
+
+    // Stack was switched, task parameter lives in scheduler frame and
+    // can't be used anymore
+    os.task.current->fn(os.task.current->arg);
+
+    UTIL_IF_1(OS_WARN_ON_TASK_EXIT,
+      log_warn("Task '%s': function returned", os.task.current->name));
+
+    UTIL_IF_1(OS_ABORT_ON_TASK_EXIT,
+      os_abort("Task %p '%s' returned", os.task.current, os.task.current->name),
+      os_exit());
+  }
+
+  // If task is waiting on a timeout, and that timeout is expired - make it ready again
+  if (task->state == OS_TASK_STATE_WAITING && timeout_is_expired(&task->wait_timeout)) {
+    task->state = OS_TASK_STATE_READY;
+  }
+
+  if (task->state == OS_TASK_STATE_READY) {
+    OS_LOG_TRACE(TASK_SWITCH, "Task %p '%s' ready, switching now", task, task->name);
+
+    if (!setjmp(os.ctx.buf)) {
+      longjmp(task->ctx.buf, 1);
+    }
+
+    UTIL_IF_1(USE_OS_STAT, task->cycles++);
+  }
+}
+
+/**
+ * Cyclic executive main loop
+ *
+ * Runs slots of schedule table one after another, each slot is given a minor
+ * frame of fixed length. If slot finishes early - waits for the frame end.
+ * If slot overruns - records it, and next slot starts right away, shifting
+ * the schedule
+ */
+__NORETURN static void os_sched_table_run(os_sched_table_t * table) {
+  log_info("Running schedule table '%s' (%d slots, %d ms)",
+    table->name, table->count, table->slot_ms);
+
+  milliseconds_t frame_start = runtime_get();
+
+  while (1) {
+    for (size_t i = 0; i < table->count; ++i) {
+      os_sched_slot_t * slot = &table->slots[i];
+
+      os.cycles++;
+
+      OS_LOG_TRACE(SLOT, "Slot %d/%d (tick=%d)", i, table->count, runtime_get());
+
+      for (uint8_t t = 0; t < slot->count; ++t) {
+        os_sched_table_run_task(slot->tasks[t]);
+      }
+
+      UTIL_IF_1(OS_WDT_AUTOFEED, wdt_feed());
+      UTIL_IF_1(OS_USE_SOFT_WDT, soft_wdt_check());
+
+      milliseconds_t elapsed = runtime_get() - frame_start;
+
+      if (elapsed > slot->max_time) {
+        slot->max_time = elapsed;
+      }
+
+      if (elapsed > table->slot_ms) {
+        slot->overruns++;
+
+        UTIL_IF_1(OS_WARN_ON_SLOT_OVERRUN,
+          log_warn("Slot %d of '%s' overrun: %d/%d ms", i, table->name, elapsed, table->slot_ms));
+
+        // Resynchronize schedule to current time
+        frame_start = runtime_get();
+      } else {
+        // Wait for end of minor frame
+        while (runtime_get() - frame_start < table->slot_ms) {
+          UTIL_IF_1(USE_OS_SLEEP_AFTER_CYCLE, os_power_mode_change(OS_SLEEP_MODE));
+          UTIL_IF_1(OS_WDT_AUTOFEED, wdt_feed());
+        }
+
+        frame_start += table->slot_ms;
+      }
+    }
+
+    table->frames++;
+  }
+}
+#endif
+
 /* Shared functions ========================================================= */
 error_t os_task_start(os_task_t * task) {
   ASSERT_RETURN(task, E_NULL);
@@ -231,6 +346,13 @@ void os_launch(void) {
   // Prepares stack for scheduler
   os_prepare_scheduler_stack_port();
 
+#if USE_OS_SCHED_TABLE
+  // If schedule table is set - run cyclic executive instead of round-robin
+  if (os.sched_table) {
+    os_sched_table_run(os.sched_table);
+  }
+#endif
+
   // Set current task to head of task list
   os.task.current = os.task.head;
 
@@ -515,6 +637,16 @@ error_t os_task_set_priority(os_task_t * task, uint8_t priority) {
   return E_OK;
 }
 
+#if OS_STAT_TRACE_TASK_HEAP
+error_t os_task_set_heap_quota(os_task_t * task, size_t quota) {
+  ASSERT_RETURN(task, E_NULL);
+
+  task->heap.quota = quota;
+
+  return E_OK;
+}
+#endif
+
 error_t os_wait_task(os_task_t * task) {
   ASSERT_RETURN(task, E_NULL);
 
@@ -555,6 +687,12 @@ error_t os_task_stat(os_task_t * task, os_task_stat_t * stat) {
   stat->stack_used = (uint8_t *) task->stack.end - (uint8_t *) task->stack.last_sp;
 #endif
 
+#if OS_STAT_TRACE_TASK_HEAP
+  stat->heap_used  = task->heap.used;
+  stat->heap_peak  = task->heap.peak;
+  stat->heap_quota = task->heap.quota;
+#endif
+
   return E_OK;
 #else
   log_warn("os_task_stat is disabled");
@@ -562,6 +700,29 @@ error_t os_task_stat(os_task_t * task, os_task_stat_t * stat) {
 #endif
 }
 
+#if USE_OS_SCHED_TABLE
+error_t os_sched_table_use(os_sched_table_t * table) {
+  if (table) {
+    ASSERT_RETURN(table->slots && table->count && table->slot_ms, E_INVAL);
+
+    for (size_t i = 0; i < table->count; ++i) {
+      table->slots[i].overruns = 0;
+      table->slots[i].max_time = 0;
+    }
+
+    table->frames = 0;
+  }
+
+  os.sched_table = table;
+
+  return E_OK;
+}
+
+os_sched_table_t * os_sched_table_get(void) {
+  return os.sched_table;
+}
+#endif
+
 const char * os_task_state_to_str(os_task_state_t state) {
   switch (state) {
     case OS_TASK_STATE_NONE:    return "NONE";
@@ -117,6 +117,39 @@ extern "C" {
 #define OS_STAT_TRACE_TASK_STACK_CYCLES            1000
 #endif
 
+/**
+ * If enabled - os_alloc will attribute every allocation to current task,
+ * tracking heap usage per task, and enforcing per-task quotas
+ * (see os_task_set_heap_quota)
+ */
+#ifndef OS_STAT_TRACE_TASK_HEAP
+#define OS_STAT_TRACE_TASK_HEAP               0
+#endif
+
+/**
+ * Enables time-triggered cyclic executive mode
+ *
+ * If enabled and a schedule table was set with os_sched_table_use, os_launch
+ * will run tasks according to the table, instead of round-robin
+ */
+#ifndef USE_OS_SCHED_TABLE
+#define USE_OS_SCHED_TABLE                    0
+#endif
+
+/**
+ * Will print warning if a schedule table slot overruns its minor frame
+ */
+#ifndef OS_WARN_ON_SLOT_OVERRUN
+#define OS_WARN_ON_SLOT_OVERRUN               1
+#endif
+
+/**
+ * If enabled, will log every handled schedule table slot
+ */
+#ifndef USE_OS_TRACE_SLOT
+#define USE_OS_TRACE_SLOT                     0
+#endif
+
 /**
  * If enabled, will log every scheduler cycle number and tick
  */
@@ -203,6 +236,68 @@ extern "C" {
     )                                                                   \
   }
 
+/**
+ * Get (previously created via OS_CREATE_SCHED_TABLE) schedule table handle
+ * from name
+ *
+ * @param __name Schedule table name
+ */
+#define OS_SCHED_TABLE(__name) &UTIL_CAT(__name, _sched_table)
+
+/**
+ * Declares a slot (minor frame) of a schedule table
+ *
+ * Tasks will be switched to in the order they are listed, each one runs
+ * until it yields back to the scheduler
+ *
+ * @param ... Task handles (OS_TASK(name)) to run in this slot
+ */
+#define OS_SCHED_SLOT(...)                                              \
+  {                                                                     \
+    .tasks = (os_task_t * const []) { __VA_ARGS__ },                    \
+    .count = UTIL_VA_ARGS_COUNT(__VA_ARGS__),                           \
+  }
+
+/**
+ * Declares an idle slot of a schedule table (no task runs in its minor
+ * frame)
+ */
+#define OS_SCHED_SLOT_IDLE                                              \
+  {                                                                     \
+    .tasks = NULL,                                                      \
+    .count = 0,                                                         \
+  }
+
+/**
+ * Creates schedule table for time-triggered cyclic executive
+ *
+ * Every slot is a minor frame of fixed length, all slots in order make
+ * up a major frame, which is repeated indefinitely
+ *
+ * Example:
+ * @code{.c}
+ * OS_CREATE_SCHED_TABLE(control, 10,
+ *   OS_SCHED_SLOT(OS_TASK(sensor), OS_TASK(regulator)),
+ *   OS_SCHED_SLOT(OS_TASK(sensor)),
+ *   OS_SCHED_SLOT(OS_TASK(sensor), OS_TASK(telemetry)),
+ *   OS_SCHED_SLOT_IDLE
+ * );
+ * @endcode
+ *
+ * @param __name     Schedule table name
+ * @param __slot_ms  Length of a slot (minor frame) in milliseconds
+ * @param ...        Slots (OS_SCHED_SLOT/OS_SCHED_SLOT_IDLE)
+ */
+#define OS_CREATE_SCHED_TABLE(__name, __slot_ms, ...)                   \
+  os_sched_slot_t UTIL_CAT(__name, _sched_slots)[] = { __VA_ARGS__ };   \
+  os_sched_table_t UTIL_CAT(__name, _sched_table) = {                   \
+    .name     = UTIL_STRINGIFY(__name),                                 \
+    .slot_ms  = __slot_ms,                                              \
+    .slots    = UTIL_CAT(__name, _sched_slots),                         \
+    .count    = UTIL_ARR_SIZE(UTIL_CAT(__name, _sched_slots)),          \
+    .frames   = 0,                                                      \
+  }
+
 /**
  * Used internally to trace OS events
  * Use USE_OS_TRACE_* defines to control which events to trace
@@ -297,6 +392,15 @@ typedef struct os_task_t {
 
   /** Mask of os_signal_t values, which is used to decide whether to call sig handler */
   uint8_t                   signals;
+
+#if OS_STAT_TRACE_TASK_HEAP
+  /** Heap usage of task, maintained by os_alloc/os_free */
+  struct {
+    size_t                  used;
+    size_t                  peak;
+    size_t                  quota;  /** 0 - unlimited */
+  } heap;
+#endif
 } os_task_t;
 
 /**
@@ -309,8 +413,49 @@ typedef struct {
   size_t          stack_used;
   size_t          cycles;
   os_task_state_t state;
+#if OS_STAT_TRACE_TASK_HEAP
+  size_t          heap_used;
+  size_t          heap_peak;
+  size_t          heap_quota;
+#endif
 } os_task_stat_t;
 
+/**
+ * Schedule table slot (minor frame)
+ */
+typedef struct {
+  /** Tasks to run in this slot, in order */
+  os_task_t * const *       tasks;
+
+  /** Number of tasks in slot */
+  uint8_t                   count;
+
+  /** Number of times slot didn't fit into its minor frame */
+  uint32_t                  overruns;
+
+  /** Longest observed slot execution time */
+  milliseconds_t            max_time;
+} os_sched_slot_t;
+
+/**
+ * Schedule table for time-triggered cyclic executive
+ */
+typedef struct {
+  const char *              name;
+
+  /** Length of each slot (minor frame) in milliseconds */
+  milliseconds_t            slot_ms;
+
+  /** Slots, all of them make up a major frame */
+  os_sched_slot_t *         slots;
+
+  /** Number of slots */
+  size_t                    count;
+
+  /** Number of completed major frames */
+  uint32_t                  frames;
+} os_sched_table_t;
+
 /* Variables ================================================================ */
 /* Shared functions ========================================================= */
 /**
@@ -438,6 +583,17 @@ os_task_t * os_task_current(void);
  */
 error_t os_task_set_priority(os_task_t * task, uint8_t priority);
 
+#if OS_STAT_TRACE_TASK_HEAP
+/**
+ * Sets maximum amount of heap memory a task can hold, os_alloc called from
+ * the task will fail, if quota would be exceeded
+ *
+ * @param task Task handle
+ * @param quota Quota in bytes, 0 - unlimited
+ */
+error_t os_task_set_heap_quota(os_task_t * task, size_t quota);
+#endif
+
 /**
  * Yields execution
  */
@@ -477,6 +633,29 @@ bool os_task_iter(os_task_t ** task);
  */
 error_t os_task_stat(os_task_t * task, os_task_stat_t * stat);
 
+#if USE_OS_SCHED_TABLE
+/**
+ * Sets schedule table to be run by os_launch
+ *
+ * Tasks, referenced by the table, still need to be started with
+ * os_task_start/os_task_create. Tasks, that are started, but not present
+ * in the table, will never run
+ *
+ * @note Must be called before os_launch
+ *
+ * @param table Schedule table handle (OS_SCHED_TABLE(name)). NULL to
+ *              return to round-robin scheduling
+ */
+error_t os_sched_table_use(os_sched_table_t * table);
+
+/**
+ * Returns schedule table, that is set to be run by os_launch
+ *
+ * @retval NULL If round-robin scheduling is used
+ */
+os_sched_table_t * os_sched_table_get(void);
+#endif
+
 /**
  * Converts os_task_state_t enum value to it's string representation
  *
@@ -0,0 +1,91 @@
+/** ========================================================================= *
+ *
+ * @file pool.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Fixed-size block pool allocator
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/pool/pool.h"
+#include "error/assertion.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/* Shared functions ========================================================= */
+error_t os_pool_init(os_pool_t * pool, void * buffer, size_t elem_size, size_t count) {
+  ASSERT_RETURN(pool && buffer, E_NULL);
+  ASSERT_RETURN(elem_size && count, E_INVAL);
+  ASSERT_RETURN(((size_t) buffer & (sizeof(void *) - 1)) == 0, E_INVAL);
+
+  pool->buffer = buffer;
+  pool->elem_size = OS_POOL_ELEM_SIZE(elem_size);
+  pool->count = count;
+  pool->peak = 0;
+
+  return os_pool_reset(pool);
+}
+
+error_t os_pool_reset(os_pool_t * pool) {
+  ASSERT_RETURN(pool, E_NULL);
+
+  pool->initialized = 0;
+  pool->free_list = NULL;
+  pool->used = 0;
+  pool->fails = 0;
+
+  return E_OK;
+}
+
+void * os_pool_alloc(os_pool_t * pool) {
+  ASSERT_RETURN(pool, NULL);
+
+  void * ptr = pool->free_list;
+
+  if (ptr) {
+    pool->free_list = *(void **) ptr;
+  } else if (pool->initialized < pool->count) {
+    ptr = pool->buffer + pool->initialized * pool->elem_size;
+    pool->initialized++;
+  } else {
+    pool->fails++;
+    return NULL;
+  }
+
+  pool->used++;
+
+  if (pool->used > pool->peak) {
+    pool->peak = pool->used;
+  }
+
+  return ptr;
+}
+
+error_t os_pool_free(os_pool_t * pool, void * ptr) {
+  ASSERT_RETURN(pool, E_NULL);
+  ASSERT_RETURN(os_pool_contains(pool, ptr), E_INVAL);
+  ASSERT_RETURN(pool->used, E_INVAL);
+
+  *(void **) ptr = pool->free_list;
+  pool->free_list = ptr;
+  pool->used--;
+
+  return E_OK;
+}
+
+bool os_pool_contains(os_pool_t * pool, void * ptr) {
+  if (!pool || (uint8_t *) ptr < pool->buffer) {
+    return false;
+  }
+
+  size_t offset = (size_t) ((uint8_t *) ptr - pool->buffer);
+
+  return offset < pool->initialized * pool->elem_size && offset % pool->elem_size == 0;
+}
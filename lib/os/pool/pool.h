@@ -0,0 +1,135 @@
+/** ========================================================================= *
+ *
+ * @file pool.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Fixed-size block pool allocator
+ *
+ * Free elements are linked through their own memory (embedded free list),
+ * so alloc and free are O(1) and there is no per-element overhead.
+ * Elements that were never allocated are handed out sequentially, so a
+ * zero-initialized pool (see OS_POOL_DEFINE) needs no init call.
+ *
+ * os_pool_alloc/os_pool_free are not reentrant, use *_isr variants from
+ * os/pool/pool_isr.h if pool is shared with interrupt handlers.
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include "error/error.h"
+#include "util/util.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/**
+ * Actual size of a pool element - rounded up to pointer size, so every
+ * element is aligned and fits the free list link
+ *
+ * @param __size Requested element size
+ */
+#define OS_POOL_ELEM_SIZE(__size) \
+  ((((__size) < sizeof(void *) ? sizeof(void *) : (__size)) + sizeof(void *) - 1) & ~(sizeof(void *) - 1))
+
+/**
+ * Size of buffer needed for a pool
+ *
+ * @param __elem_size Element size
+ * @param __count Element count
+ */
+#define OS_POOL_BUFFER_SIZE(__elem_size, __count) \
+  (OS_POOL_ELEM_SIZE(__elem_size) * (__count))
+
+/**
+ * Defines a pool
+ *
+ * Creates 2 variables - buffer (name+_os_pool_buffer) and pool context
+ *
+ * @param __name Pool name
+ * @param __elem_size Element size
+ * @param __count Element count
+ */
+#define OS_POOL_DEFINE(__name, __elem_size, __count)                            \
+  void * UTIL_CAT(__name, _os_pool_buffer)                                      \
+      [OS_POOL_BUFFER_SIZE(__elem_size, __count) / sizeof(void *)] = {0};       \
+  os_pool_t __name = {                                                          \
+    .buffer = (uint8_t *) UTIL_CAT(__name, _os_pool_buffer),                    \
+    .elem_size = OS_POOL_ELEM_SIZE(__elem_size),                                \
+    .count = (__count),                                                         \
+  }
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Pool Context
+ */
+typedef struct {
+  uint8_t * buffer;     /** Pool memory */
+  size_t elem_size;     /** Element size (see OS_POOL_ELEM_SIZE) */
+  size_t count;         /** Element count */
+  size_t initialized;   /** Elements that were handed out at least once */
+  void * free_list;     /** Freed elements, linked through first word */
+
+  /** Statistics */
+  size_t used;          /** Elements currently allocated */
+  size_t peak;          /** High-water mark of used */
+  size_t fails;         /** Allocations failed because pool was empty */
+} os_pool_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes a pool
+ *
+ * @param pool Pool Context
+ * @param buffer Pool memory, at least OS_POOL_BUFFER_SIZE(elem_size, count)
+ *               bytes, aligned to pointer size
+ * @param elem_size Element size
+ * @param count Element count
+ */
+error_t os_pool_init(os_pool_t * pool, void * buffer, size_t elem_size, size_t count);
+
+/**
+ * Returns all elements to the pool, statistics (except peak) are reset
+ *
+ * @param pool Pool Context
+ */
+error_t os_pool_reset(os_pool_t * pool);
+
+/**
+ * Allocates an element
+ *
+ * @param pool Pool Context
+ * @retval Pointer to element, or NULL if pool is empty
+ */
+void * os_pool_alloc(os_pool_t * pool);
+
+/**
+ * Returns an element to the pool
+ *
+ * @note Double free is not detected
+ *
+ * @param pool Pool Context
+ * @param ptr Element previously allocated from this pool
+ */
+error_t os_pool_free(os_pool_t * pool, void * ptr);
+
+/**
+ * Checks if ptr points to an element of the pool
+ *
+ * @param pool Pool Context
+ * @param ptr Pointer to check
+ */
+bool os_pool_contains(os_pool_t * pool, void * ptr);
+
+#ifdef __cplusplus
+}
+#endif
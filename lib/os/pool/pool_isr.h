@@ -0,0 +1,59 @@
+/** ========================================================================= *
+ *
+ * @file pool_isr.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Interrupt-safe wrappers for os_pool
+ *
+ * Kept apart from pool.h, so users of plain pool don't depend on IRQ port.
+ * Previous IRQ mask is saved and restored, so wrappers can be called with
+ * IRQs already disabled, or from an interrupt handler itself
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "os/pool/pool.h"
+#include "os/irq/irq.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Allocates an element, safe to use from interrupt handlers
+ *
+ * @param pool Pool Context
+ */
+__STATIC_INLINE void * os_pool_alloc_isr(os_pool_t * pool) {
+  uint32_t irq = os_irq_save();
+  void * ptr = os_pool_alloc(pool);
+  os_irq_restore(irq);
+
+  return ptr;
+}
+
+/**
+ * Returns an element to the pool, safe to use from interrupt handlers
+ *
+ * @param pool Pool Context
+ * @param ptr Element previously allocated from this pool
+ */
+__STATIC_INLINE error_t os_pool_free_isr(os_pool_t * pool, void * ptr) {
+  uint32_t irq = os_irq_save();
+  error_t err = os_pool_free(pool, ptr);
+  os_irq_restore(irq);
+
+  return err;
+}
+
+#ifdef __cplusplus
+}
+#endif
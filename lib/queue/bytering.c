@@ -0,0 +1,274 @@
+/** ========================================================================= *
+ *
+ * @file bytering.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Byte stream ring buffer
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "queue/bytering.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/** Load index written by the other side */
+#define BYTERING_LOAD_ACQUIRE(__x)        __atomic_load_n(&(__x), __ATOMIC_ACQUIRE)
+
+/** Publish own index to the other side */
+#define BYTERING_STORE_RELEASE(__x, __v)  __atomic_store_n(&(__x), (__v), __ATOMIC_RELEASE)
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Advances head by size, reporting HIGH watermark if it was crossed
+ */
+__STATIC_INLINE void bytering_advance_head(bytering_t * ring, size_t head, size_t used, size_t size) {
+  BYTERING_STORE_RELEASE(ring->head, head + size);
+
+  if (ring->watermark.high && used < ring->watermark.high && used + size >= ring->watermark.high) {
+    ring->watermark.cb(ring->watermark.ctx, ring, BYTERING_EVENT_HIGH);
+  }
+}
+
+/**
+ * Advances tail by size, reporting LOW watermark if it was crossed
+ */
+__STATIC_INLINE void bytering_advance_tail(bytering_t * ring, size_t tail, size_t used, size_t size) {
+  BYTERING_STORE_RELEASE(ring->tail, tail + size);
+
+  if (ring->watermark.high && used > ring->watermark.low && used - size <= ring->watermark.low) {
+    ring->watermark.cb(ring->watermark.ctx, ring, BYTERING_EVENT_LOW);
+  }
+}
+
+/* Shared functions ========================================================= */
+error_t bytering_init(bytering_t * ring, uint8_t * buffer, size_t capacity) {
+  ASSERT_RETURN(ring && buffer, E_NULL);
+  ASSERT_RETURN(capacity && (capacity & (capacity - 1)) == 0, E_INVAL);
+
+  memset(ring, 0, sizeof(bytering_t));
+
+  ring->buffer = buffer;
+  ring->mask = capacity - 1;
+
+  return E_OK;
+}
+
+error_t bytering_reset(bytering_t * ring) {
+  ASSERT_RETURN(ring, E_NULL);
+
+  ring->head = 0;
+  ring->tail = 0;
+
+  return E_OK;
+}
+
+error_t bytering_set_watermarks(
+    bytering_t * ring, size_t high, size_t low, bytering_watermark_cb_t cb, void * ctx
+) {
+  ASSERT_RETURN(ring, E_NULL);
+  ASSERT_RETURN(!high || (cb && low < high && high <= ring->mask + 1), E_INVAL);
+
+  ring->watermark.high = 0;
+  ring->watermark.low = low;
+  ring->watermark.cb = cb;
+  ring->watermark.ctx = ctx;
+  ring->watermark.high = high;
+
+  return E_OK;
+}
+
+size_t bytering_write(bytering_t * ring, const void * data, size_t size) {
+  ASSERT_RETURN(ring && data, 0);
+
+  size_t head = ring->head;
+  size_t used = head - BYTERING_LOAD_ACQUIRE(ring->tail);
+
+  size = UTIL_MIN(size, ring->mask + 1 - used);
+
+  if (!size) {
+    return 0;
+  }
+
+  size_t start = head & ring->mask;
+  size_t first = UTIL_MIN(size, ring->mask + 1 - start);
+
+  memcpy(ring->buffer + start, data, first);
+  memcpy(ring->buffer, (const uint8_t *) data + first, size - first);
+
+  bytering_advance_head(ring, head, used, size);
+
+  return size;
+}
+
+size_t bytering_read(bytering_t * ring, void * data, size_t size) {
+  ASSERT_RETURN(ring && data, 0);
+
+  size_t tail = ring->tail;
+  size_t used = BYTERING_LOAD_ACQUIRE(ring->head) - tail;
+
+  size = UTIL_MIN(size, used);
+
+  if (!size) {
+    return 0;
+  }
+
+  size_t start = tail & ring->mask;
+  size_t first = UTIL_MIN(size, ring->mask + 1 - start);
+
+  memcpy(data, ring->buffer + start, first);
+  memcpy((uint8_t *) data + first, ring->buffer, size - first);
+
+  bytering_advance_tail(ring, tail, used, size);
+
+  return size;
+}
+
+size_t bytering_reserve_contiguous(bytering_t * ring, uint8_t ** data) {
+  ASSERT_RETURN(ring && data, 0);
+
+  size_t head = ring->head;
+  size_t space = ring->mask + 1 - (head - BYTERING_LOAD_ACQUIRE(ring->tail));
+  size_t start = head & ring->mask;
+
+  *data = ring->buffer + start;
+
+  return UTIL_MIN(space, ring->mask + 1 - start);
+}
+
+error_t bytering_publish(bytering_t * ring, size_t size) {
+  ASSERT_RETURN(ring, E_NULL);
+
+  size_t head = ring->head;
+  size_t used = head - BYTERING_LOAD_ACQUIRE(ring->tail);
+
+  ASSERT_RETURN(size <= ring->mask + 1 - used, E_OVERFLOW);
+
+  if (size) {
+    bytering_advance_head(ring, head, used, size);
+  }
+
+  return E_OK;
+}
+
+size_t bytering_peek_contiguous(bytering_t * ring, const uint8_t ** data) {
+  ASSERT_RETURN(ring && data, 0);
+
+  size_t tail = ring->tail;
+  size_t used = BYTERING_LOAD_ACQUIRE(ring->head) - tail;
+  size_t start = tail & ring->mask;
+
+  *data = ring->buffer + start;
+
+  return UTIL_MIN(used, ring->mask + 1 - start);
+}
+
+error_t bytering_commit(bytering_t * ring, size_t size) {
+  ASSERT_RETURN(ring, E_NULL);
+
+  size_t tail = ring->tail;
+  size_t used = BYTERING_LOAD_ACQUIRE(ring->head) - tail;
+
+  ASSERT_RETURN(size <= used, E_UNDERFLOW);
+
+  if (size) {
+    bytering_advance_tail(ring, tail, used, size);
+  }
+
+  return E_OK;
+}
+
+size_t bytering_size(bytering_t * ring) {
+  if (!ring) {
+    return 0;
+  }
+
+  size_t tail = BYTERING_LOAD_ACQUIRE(ring->tail);
+  size_t head = BYTERING_LOAD_ACQUIRE(ring->head);
+
+  return head - tail;
+}
+
+size_t bytering_space(bytering_t * ring) {
+  return ring ? ring->mask + 1 - bytering_size(ring) : 0;
+}
+
+#if USE_BYTERING_VFS
+error_t bytering_vfs_read(void * ctx, vfs_file_t * file, uint8_t * buffer, size_t size, vfs_read_flags_t flags) {
+  bytering_t * ring = ctx;
+
+  ASSERT_RETURN(ring && buffer, E_NULL);
+
+  if (flags & VFS_READ_FLAG_NOBLOCK) {
+    if (bytering_size(ring) < size) {
+      return E_EMPTY;
+    }
+
+    bytering_read(ring, buffer, size);
+
+    return E_OK;
+  }
+
+  while (size) {
+    size_t read = bytering_read(ring, buffer, size);
+
+    buffer += read;
+    size -= read;
+
+    if (size) {
+      BYTERING_VFS_WAIT();
+    }
+  }
+
+  return E_OK;
+}
+
+error_t bytering_vfs_write(void * ctx, vfs_file_t * file, const uint8_t * buffer, size_t size) {
+  bytering_t * ring = ctx;
+
+  ASSERT_RETURN(ring && buffer, E_NULL);
+
+  return bytering_write(ring, buffer, size) == size ? E_OK : E_OVERFLOW;
+}
+
+error_t bytering_vfs_writev(void * ctx, vfs_file_t * file, const vfs_iovec_t * iov, size_t count) {
+  bytering_t * ring = ctx;
+
+  ASSERT_RETURN(ring && iov, E_NULL);
+
+  for (size_t i = 0; i < count; ++i) {
+    if (bytering_write(ring, iov[i].base, iov[i].size) != iov[i].size) {
+      return E_OVERFLOW;
+    }
+  }
+
+  return E_OK;
+}
+
+error_t bytering_vfs_ioctl(void * ctx, vfs_file_t * file, int cmd, va_list args) {
+  bytering_t * ring = ctx;
+
+  ASSERT_RETURN(ring, E_NULL);
+
+  switch (cmd) {
+    case VFS_IOCTL_TELL: {
+      size_t * size = va_arg(args, size_t *);
+      ASSERT_RETURN(size, E_NULL);
+      *size = bytering_size(ring);
+      return E_OK;
+    }
+
+    default:
+      break;
+  }
+
+  return E_NOTIMPL;
+}
+#endif
@@ -0,0 +1,287 @@
+/** ========================================================================= *
+ *
+ * @file bytering.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Byte stream ring buffer
+ *
+ * FIFO of raw bytes for UART, TTY and log streams. Bulk read/write take at
+ * most two memcpy's. For zero-copy (e.g. DMA) access, producer can reserve
+ * a contiguous free region and publish it after filling, and consumer can
+ * peek a contiguous filled region and commit it after processing.
+ *
+ * Like spsc_ring_t, is safe for one producer and one consumer (e.g. ISR
+ * and task) without masking interrupts. Capacity must be a power of 2.
+ *
+ * Can be used as VFS block device backend (see BYTERING_VFS_BLOCK).
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include "util/compiler.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Enables VFS block device adapter
+ */
+#ifndef USE_BYTERING_VFS
+#define USE_BYTERING_VFS 1
+#endif
+
+/**
+ * Called by blocking VFS read, while waiting for data
+ * Busy-waits by default, can be set to yield, e.g. os_yield()
+ */
+#ifndef BYTERING_VFS_WAIT
+#define BYTERING_VFS_WAIT()
+#endif
+
+#if USE_BYTERING_VFS
+#include "vfs/vfs.h"
+#endif
+
+/* Macros =================================================================== */
+/**
+ * Defines a byte ring
+ *
+ * @note Actually consists of 2 statements - declaration of buffer and ring
+ *
+ * @param name Ring name (variable)
+ * @param cap Capacity in bytes, power of 2
+ */
+#define BYTERING_DEFINE(name, cap)                                              \
+  _Static_assert(((cap) & ((cap) - 1)) == 0 && (cap),                           \
+                 "Byte ring capacity must be power of 2");                      \
+  uint8_t UTIL_CAT(name, _bytering_buf)[cap];                                   \
+  bytering_t name = {                                                           \
+    .buffer = UTIL_CAT(name, _bytering_buf),                                    \
+    .mask   = (cap) - 1,                                                        \
+  }
+
+#if USE_BYTERING_VFS
+/**
+ * VFS block data for a byte ring, to be passed to vfs_create_block
+ *
+ * @param ring Pointer to bytering_t
+ */
+#define BYTERING_VFS_BLOCK(ring)                                                \
+  ((vfs_block_data_t) {                                                         \
+    .ctx    = (ring),                                                           \
+    .read   = bytering_vfs_read,                                                \
+    .write  = bytering_vfs_write,                                               \
+    .ioctl  = bytering_vfs_ioctl,                                               \
+    .writev = bytering_vfs_writev,                                              \
+  })
+#endif
+
+/* Enums ==================================================================== */
+/**
+ * Watermark event
+ */
+typedef enum {
+  BYTERING_EVENT_HIGH = 0,  /** Fill level rose to high watermark */
+  BYTERING_EVENT_LOW,       /** Fill level dropped to low watermark */
+} bytering_event_t;
+
+/* Types ==================================================================== */
+/**
+ * Forward declaration of byte ring
+ */
+typedef struct bytering_s bytering_t;
+
+/**
+ * Watermark callback
+ *
+ * @note Called from producer context for BYTERING_EVENT_HIGH and from
+ *       consumer context for BYTERING_EVENT_LOW
+ *
+ * @param ctx User context
+ * @param ring Ring
+ * @param event Event
+ */
+typedef void (*bytering_watermark_cb_t)(void * ctx, bytering_t * ring, bytering_event_t event);
+
+/**
+ * Byte ring context
+ */
+struct bytering_s {
+  uint8_t * buffer;   /** Data buffer */
+  size_t mask;        /** Capacity - 1 */
+
+  size_t head;        /** Next byte to write, written by producer only */
+  size_t tail;        /** Next byte to read, written by consumer only */
+
+  /**
+   * Watermarks
+   */
+  struct {
+    size_t high;                  /** Level, that triggers HIGH, 0 to disable */
+    size_t low;                   /** Level, that triggers LOW */
+    bytering_watermark_cb_t cb;
+    void * ctx;
+  } watermark;
+};
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes ring
+ *
+ * @param ring Ring handle
+ * @param buffer Data buffer
+ * @param capacity Buffer size, power of 2
+ */
+error_t bytering_init(bytering_t * ring, uint8_t * buffer, size_t capacity);
+
+/**
+ * Drops all data
+ *
+ * @note Not safe to call while producer or consumer are active
+ *
+ * @param ring Ring handle
+ */
+error_t bytering_reset(bytering_t * ring);
+
+/**
+ * Sets watermarks
+ *
+ * HIGH is reported when a write makes fill level reach high, LOW is
+ * reported when a read makes fill level drop to low
+ *
+ * @param ring Ring handle
+ * @param high High watermark, 0 to disable watermarks
+ * @param low Low watermark, less than high
+ * @param cb Callback
+ * @param ctx User context passed to cb
+ */
+error_t bytering_set_watermarks(
+    bytering_t * ring, size_t high, size_t low, bytering_watermark_cb_t cb, void * ctx
+);
+
+/**
+ * Write up to size bytes (producer)
+ *
+ * @param ring Ring handle
+ * @param data Data to write
+ * @param size Data size
+ * @retval Bytes written, less than size if ring got full
+ */
+size_t bytering_write(bytering_t * ring, const void * data, size_t size);
+
+/**
+ * Read up to size bytes (consumer)
+ *
+ * @param ring Ring handle
+ * @param data Buffer to read to
+ * @param size Max bytes to read
+ * @retval Bytes read
+ */
+size_t bytering_read(bytering_t * ring, void * data, size_t size);
+
+/**
+ * Get contiguous region of free space (producer)
+ *
+ * @note Region is only reserved until bytering_publish, nothing else may
+ *       be written in between
+ *
+ * @param ring Ring handle
+ * @param data Start of the region
+ * @retval Region size, may be less than total free space, if it wraps
+ */
+size_t bytering_reserve_contiguous(bytering_t * ring, uint8_t ** data);
+
+/**
+ * Publish size bytes, written into region from bytering_reserve_contiguous
+ * (producer)
+ *
+ * @param ring Ring handle
+ * @param size Bytes written
+ */
+error_t bytering_publish(bytering_t * ring, size_t size);
+
+/**
+ * Get contiguous region of data (consumer)
+ *
+ * @param ring Ring handle
+ * @param data Start of the region
+ * @retval Region size, may be less than total data size, if it wraps
+ */
+size_t bytering_peek_contiguous(bytering_t * ring, const uint8_t ** data);
+
+/**
+ * Drop size bytes from the ring, after processing data from
+ * bytering_peek_contiguous (consumer)
+ *
+ * @param ring Ring handle
+ * @param size Bytes processed
+ */
+error_t bytering_commit(bytering_t * ring, size_t size);
+
+/**
+ * Returns bytes stored
+ *
+ * @param ring Ring handle
+ */
+size_t bytering_size(bytering_t * ring);
+
+/**
+ * Returns free space in bytes
+ *
+ * @param ring Ring handle
+ */
+size_t bytering_space(bytering_t * ring);
+
+/**
+ * Returns ring capacity in bytes
+ *
+ * @param ring Ring handle
+ */
+__STATIC_INLINE size_t bytering_capacity(bytering_t * ring) {
+  return ring ? ring->mask + 1 : 0;
+}
+
+#if USE_BYTERING_VFS
+/**
+ * VFS block read callback, ctx is bytering_t
+ *
+ * @note With VFS_READ_FLAG_NOBLOCK returns E_EMPTY, if less than size
+ *       bytes are available, otherwise waits for them
+ */
+error_t bytering_vfs_read(void * ctx, vfs_file_t * file, uint8_t * buffer, size_t size, vfs_read_flags_t flags);
+
+/**
+ * VFS block write callback, ctx is bytering_t
+ *
+ * @note Returns E_OVERFLOW if not everything fit, what fit is written
+ */
+error_t bytering_vfs_write(void * ctx, vfs_file_t * file, const uint8_t * buffer, size_t size);
+
+/**
+ * VFS block writev callback, ctx is bytering_t
+ *
+ * @note Returns E_OVERFLOW if not everything fit, what fit is written
+ */
+error_t bytering_vfs_writev(void * ctx, vfs_file_t * file, const vfs_iovec_t * iov, size_t count);
+
+/**
+ * VFS block ioctl callback, ctx is bytering_t
+ *
+ * @note VFS_IOCTL_TELL returns bytes stored
+ */
+error_t bytering_vfs_ioctl(void * ctx, vfs_file_t * file, int cmd, va_list args);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,179 @@
+/** ========================================================================= *
+ *
+ * @file pqueue.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Intrusive binary min-heap priority queue
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "queue/pqueue.h"
+#include "error/assertion.h"
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+#define PQUEUE_PARENT(__i)  (((__i) - 1) / 2)
+#define PQUEUE_LEFT(__i)    (2 * (__i) + 1)
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Returns true if key a has higher priority than b
+ */
+__STATIC_INLINE bool pqueue_key_less(uint32_t a, uint32_t b) {
+#if USE_PQUEUE_KEY_WRAP
+  return (int32_t) (a - b) < 0;
+#else
+  return a < b;
+#endif
+}
+
+/**
+ * Places node at index
+ */
+__STATIC_INLINE void pqueue_place(pqueue_t * pq, pqueue_node_t * node, size_t index) {
+  pq->nodes[index] = node;
+  node->index = index;
+}
+
+/**
+ * Moves node up from index, until parent has lower or equal key
+ * Node is only written once, at its final place
+ */
+__STATIC_INLINE void pqueue_sift_up(pqueue_t * pq, pqueue_node_t * node, size_t index) {
+  while (index) {
+    size_t parent = PQUEUE_PARENT(index);
+
+    if (!pqueue_key_less(node->key, pq->nodes[parent]->key)) {
+      break;
+    }
+
+    pqueue_place(pq, pq->nodes[parent], index);
+    index = parent;
+  }
+
+  pqueue_place(pq, node, index);
+}
+
+/**
+ * Moves node down from index, until both children have higher or equal key
+ */
+__STATIC_INLINE void pqueue_sift_down(pqueue_t * pq, pqueue_node_t * node, size_t index) {
+  size_t child;
+
+  while ((child = PQUEUE_LEFT(index)) < pq->size) {
+    if (child + 1 < pq->size && pqueue_key_less(pq->nodes[child + 1]->key, pq->nodes[child]->key)) {
+      child++;
+    }
+
+    if (!pqueue_key_less(pq->nodes[child]->key, node->key)) {
+      break;
+    }
+
+    pqueue_place(pq, pq->nodes[child], index);
+    index = child;
+  }
+
+  pqueue_place(pq, node, index);
+}
+
+/**
+ * Restores heap property for node at index, after its key changed
+ */
+__STATIC_INLINE void pqueue_fix(pqueue_t * pq, pqueue_node_t * node, size_t index) {
+  if (index && pqueue_key_less(node->key, pq->nodes[PQUEUE_PARENT(index)]->key)) {
+    pqueue_sift_up(pq, node, index);
+  } else {
+    pqueue_sift_down(pq, node, index);
+  }
+}
+
+/* Shared functions ========================================================= */
+error_t pqueue_init(pqueue_t * pq, pqueue_node_t ** nodes, size_t capacity) {
+  ASSERT_RETURN(pq && nodes, E_NULL);
+  ASSERT_RETURN(capacity, E_INVAL);
+
+  pq->nodes = nodes;
+  pq->capacity = capacity;
+  pq->size = 0;
+
+  return E_OK;
+}
+
+error_t pqueue_node_init(pqueue_node_t * node) {
+  ASSERT_RETURN(node, E_NULL);
+
+  *node = PQUEUE_NODE_INIT();
+
+  return E_OK;
+}
+
+error_t pqueue_clear(pqueue_t * pq) {
+  ASSERT_RETURN(pq, E_NULL);
+
+  for (size_t i = 0; i < pq->size; ++i) {
+    pq->nodes[i]->index = PQUEUE_INDEX_NONE;
+  }
+
+  pq->size = 0;
+
+  return E_OK;
+}
+
+error_t pqueue_push(pqueue_t * pq, pqueue_node_t * node, uint32_t key) {
+  ASSERT_RETURN(pq && node, E_NULL);
+  ASSERT_RETURN(node->index == PQUEUE_INDEX_NONE, E_INUSE);
+
+  if (pq->size == pq->capacity) {
+    return E_OVERFLOW;
+  }
+
+  node->key = key;
+  pqueue_sift_up(pq, node, pq->size++);
+
+  return E_OK;
+}
+
+pqueue_node_t * pqueue_pop(pqueue_t * pq) {
+  if (!pq || !pq->size) {
+    return NULL;
+  }
+
+  pqueue_node_t * top = pq->nodes[0];
+  top->index = PQUEUE_INDEX_NONE;
+
+  if (--pq->size) {
+    pqueue_sift_down(pq, pq->nodes[pq->size], 0);
+  }
+
+  return top;
+}
+
+error_t pqueue_update(pqueue_t * pq, pqueue_node_t * node, uint32_t key) {
+  ASSERT_RETURN(pq && node, E_NULL);
+  ASSERT_RETURN(pqueue_contains(pq, node), E_NOTFOUND);
+
+  node->key = key;
+  pqueue_fix(pq, node, node->index);
+
+  return E_OK;
+}
+
+error_t pqueue_remove(pqueue_t * pq, pqueue_node_t * node) {
+  ASSERT_RETURN(pq && node, E_NULL);
+  ASSERT_RETURN(pqueue_contains(pq, node), E_NOTFOUND);
+
+  size_t index = node->index;
+  node->index = PQUEUE_INDEX_NONE;
+
+  if (index != --pq->size) {
+    pqueue_fix(pq, pq->nodes[pq->size], index);
+  }
+
+  return E_OK;
+}
@@ -0,0 +1,206 @@
+/** ========================================================================= *
+ *
+ * @file pqueue.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Intrusive binary min-heap priority queue
+ *
+ * Keeps items ordered by a 32-bit key (e.g. deadline tick), lowest first.
+ * Items embed pqueue_node_t, queue itself stores only pointers to nodes
+ * in a caller provided array, so nothing is copied or allocated.
+ * Every node knows its position in the heap, which makes remove and key
+ * update O(log n) without searching.
+ *
+ * push/pop/update/remove are O(log n), peek is O(1).
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include "util/compiler.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Compare keys as wrapping timestamps: a < b if (int32_t)(a - b) < 0
+ * Makes tick deadlines work across counter overflow, as long as all keys
+ * in the queue are less than 2^31 apart
+ */
+#ifndef USE_PQUEUE_KEY_WRAP
+#define USE_PQUEUE_KEY_WRAP 0
+#endif
+
+/**
+ * Index of a node, that is not in any queue
+ */
+#define PQUEUE_INDEX_NONE SIZE_MAX
+
+/* Macros =================================================================== */
+/**
+ * Defines a priority queue
+ *
+ * @note Actually consists of 2 statements - declaration of buffer and queue
+ * @note pqueue_init can be used instead for explicit initialization
+ *
+ * @param name Queue name (variable)
+ * @param cap Capacity of queue
+ */
+#define PQUEUE_DEFINE(name, cap)                                                \
+  pqueue_node_t * UTIL_CAT(name, _pqueue_buf)[cap];                             \
+  pqueue_t name = {                                                             \
+    .nodes    = UTIL_CAT(name, _pqueue_buf),                                    \
+    .capacity = (cap),                                                          \
+    .size     = 0,                                                              \
+  }
+
+/**
+ * Static initializer for a node, that is not in a queue
+ */
+#define PQUEUE_NODE_INIT() ((pqueue_node_t) {.key = 0, .index = PQUEUE_INDEX_NONE})
+
+/**
+ * Get item, that embeds the node
+ *
+ * @param node Pointer to pqueue_node_t
+ * @param type Item type
+ * @param member Name of pqueue_node_t member in type
+ */
+#define PQUEUE_ENTRY(node, type, member)                                        \
+  ((type *) ((uint8_t *) (node) - offsetof(type, member)))
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Queue node, embedded in user item
+ */
+typedef struct {
+  uint32_t key;   /** Priority, lowest is popped first */
+  size_t index;   /** Position in heap, PQUEUE_INDEX_NONE if not queued */
+} pqueue_node_t;
+
+/**
+ * Priority queue context
+ */
+typedef struct {
+  pqueue_node_t ** nodes;   /** Heap array */
+  size_t capacity;          /** Max nodes */
+  size_t size;              /** Nodes in queue */
+} pqueue_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes queue
+ *
+ * @note PQUEUE_DEFINE can be used instead for automatic buffer creation and
+ *       queue initialization
+ *
+ * @param pq Queue handle
+ * @param nodes Buffer for capacity node pointers
+ * @param capacity Max nodes in queue
+ */
+error_t pqueue_init(pqueue_t * pq, pqueue_node_t ** nodes, size_t capacity);
+
+/**
+ * Initializes node, must be called once before node is pushed first time
+ *
+ * @param node Node
+ */
+error_t pqueue_node_init(pqueue_node_t * node);
+
+/**
+ * Drops all nodes
+ *
+ * @param pq Queue handle
+ */
+error_t pqueue_clear(pqueue_t * pq);
+
+/**
+ * Push node with key
+ *
+ * @param pq Queue handle
+ * @param node Node, that is not in a queue
+ * @param key Node priority
+ * @retval E_OVERFLOW if queue is full
+ * @retval E_INUSE if node is already queued
+ */
+error_t pqueue_push(pqueue_t * pq, pqueue_node_t * node, uint32_t key);
+
+/**
+ * Pop node with lowest key
+ *
+ * @param pq Queue handle
+ * @retval Node or NULL if queue is empty
+ */
+pqueue_node_t * pqueue_pop(pqueue_t * pq);
+
+/**
+ * Change key of a queued node, moving it in either direction
+ * (covers decrease-key)
+ *
+ * @param pq Queue handle
+ * @param node Queued node
+ * @param key New priority
+ * @retval E_NOTFOUND if node is not in this queue
+ */
+error_t pqueue_update(pqueue_t * pq, pqueue_node_t * node, uint32_t key);
+
+/**
+ * Remove queued node
+ *
+ * @param pq Queue handle
+ * @param node Queued node
+ * @retval E_NOTFOUND if node is not in this queue
+ */
+error_t pqueue_remove(pqueue_t * pq, pqueue_node_t * node);
+
+/**
+ * Get node with lowest key, without popping it
+ *
+ * @param pq Queue handle
+ * @retval Node or NULL if queue is empty
+ */
+__STATIC_INLINE pqueue_node_t * pqueue_peek(pqueue_t * pq) {
+  return pq && pq->size ? pq->nodes[0] : NULL;
+}
+
+/**
+ * Checks whether node is in the queue
+ *
+ * @param pq Queue handle
+ * @param node Node
+ */
+__STATIC_INLINE bool pqueue_contains(pqueue_t * pq, pqueue_node_t * node) {
+  return pq && node && node->index < pq->size && pq->nodes[node->index] == node;
+}
+
+/**
+ * Returns nodes count
+ *
+ * @param pq Queue handle
+ */
+__STATIC_INLINE size_t pqueue_size(pqueue_t * pq) {
+  return pq ? pq->size : 0;
+}
+
+/**
+ * Returns queue capacity
+ *
+ * @param pq Queue handle
+ */
+__STATIC_INLINE size_t pqueue_capacity(pqueue_t * pq) {
+  return pq ? pq->capacity : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
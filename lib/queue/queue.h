@@ -16,6 +16,7 @@ extern "C" {
 /* Includes ================================================================= */
 #include "error/error.h"
 #include "util/compiler.h"
+#include "util/util.h"
 #include <stdbool.h>
 #include <stddef.h>
 
@@ -40,6 +41,86 @@ extern "C" {
         .tail     = 0                                       \
     }
 
+/**
+ * Defines a queue type, that stores elements of type T by value, and
+ * inline functions to work with it:
+ *   name_t, name_init, name_clear, name_size, name_capacity,
+ *   name_push, name_push_front, name_pop, name_peek
+ *
+ * Semantics and return values are the same as of queue_t functions, but
+ * all cap elements are usable
+ *
+ * @note Zero-initialized name_t is an empty queue, so name_init is optional
+ *
+ * @param name Queue type name prefix
+ * @param T Element type
+ * @param cap Capacity of queue
+ */
+#define QUEUE_DEFINE_TYPED(name, T, cap)                                                  \
+  typedef struct {                                                                        \
+    T      elements[cap];                                                                 \
+    size_t size;                                                                          \
+    size_t head;                                                                          \
+    size_t tail;                                                                          \
+  } UTIL_CAT(name, _t);                                                                   \
+                                                                                          \
+  __STATIC_INLINE void UTIL_CAT(name, _init)(UTIL_CAT(name, _t) * q) {                    \
+    q->size = 0;                                                                          \
+    q->head = 0;                                                                          \
+    q->tail = 0;                                                                          \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE void UTIL_CAT(name, _clear)(UTIL_CAT(name, _t) * q) {                   \
+    UTIL_CAT(name, _init)(q);                                                             \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE size_t UTIL_CAT(name, _size)(const UTIL_CAT(name, _t) * q) {            \
+    return q->size;                                                                       \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE size_t UTIL_CAT(name, _capacity)(const UTIL_CAT(name, _t) * q) {        \
+    (void) q;                                                                             \
+    return (cap);                                                                         \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE error_t UTIL_CAT(name, _push)(UTIL_CAT(name, _t) * q, T data) {         \
+    if (q->size == (cap)) {                                                               \
+      return E_OVERFLOW;                                                                  \
+    }                                                                                     \
+    q->elements[q->head] = data;                                                          \
+    q->head = q->head + 1 == (cap) ? 0 : q->head + 1;                                     \
+    q->size++;                                                                            \
+    return E_OK;                                                                          \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE error_t UTIL_CAT(name, _push_front)(UTIL_CAT(name, _t) * q, T data) {   \
+    if (q->size == (cap)) {                                                               \
+      return E_OVERFLOW;                                                                  \
+    }                                                                                     \
+    q->tail = q->tail ? q->tail - 1 : (cap) - 1;                                          \
+    q->elements[q->tail] = data;                                                          \
+    q->size++;                                                                            \
+    return E_OK;                                                                          \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE error_t UTIL_CAT(name, _pop)(UTIL_CAT(name, _t) * q, T * data) {        \
+    if (!q->size) {                                                                       \
+      return E_UNDERFLOW;                                                                 \
+    }                                                                                     \
+    *data = q->elements[q->tail];                                                         \
+    q->tail = q->tail + 1 == (cap) ? 0 : q->tail + 1;                                     \
+    q->size--;                                                                            \
+    return E_OK;                                                                          \
+  }                                                                                       \
+                                                                                          \
+  __STATIC_INLINE error_t UTIL_CAT(name, _peek)(const UTIL_CAT(name, _t) * q, T * data) { \
+    if (!q->size) {                                                                       \
+      return E_EMPTY;                                                                     \
+    }                                                                                     \
+    *data = q->elements[q->tail];                                                         \
+    return E_OK;                                                                          \
+  }
+
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /**
@@ -0,0 +1,195 @@
+/** ========================================================================= *
+ *
+ * @file spsc_ring.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "queue/spsc_ring.h"
+#include "error/assertion.h"
+#include <string.h>
+
+/* Defines ================================================================== */
+/* Macros =================================================================== */
+/** Load index written by the other side */
+#define SPSC_LOAD_ACQUIRE(__x)        __atomic_load_n(&(__x), __ATOMIC_ACQUIRE)
+
+/** Publish own index to the other side */
+#define SPSC_STORE_RELEASE(__x, __v)  __atomic_store_n(&(__x), (__v), __ATOMIC_RELEASE)
+
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+/**
+ * Copies count elements into the ring starting at index, wrapping around
+ */
+__STATIC_INLINE void spsc_ring_copy_in(spsc_ring_t * ring, size_t index, const uint8_t * src, size_t count) {
+  size_t start = index & ring->mask;
+  size_t first = UTIL_MIN(count, ring->mask + 1 - start);
+
+  memcpy(ring->buffer + start * ring->elem_size, src, first * ring->elem_size);
+
+  if (count > first) {
+    memcpy(ring->buffer, src + first * ring->elem_size, (count - first) * ring->elem_size);
+  }
+}
+
+/**
+ * Copies count elements out of the ring starting at index, wrapping around
+ */
+__STATIC_INLINE void spsc_ring_copy_out(spsc_ring_t * ring, size_t index, uint8_t * dst, size_t count) {
+  size_t start = index & ring->mask;
+  size_t first = UTIL_MIN(count, ring->mask + 1 - start);
+
+  memcpy(dst, ring->buffer + start * ring->elem_size, first * ring->elem_size);
+
+  if (count > first) {
+    memcpy(dst + first * ring->elem_size, ring->buffer, (count - first) * ring->elem_size);
+  }
+}
+
+/**
+ * Free space as seen by producer, refreshes cached tail only if needed
+ */
+__STATIC_INLINE size_t spsc_ring_space(spsc_ring_t * ring, size_t head, size_t want) {
+  size_t space = ring->mask + 1 - (head - ring->producer.tail_cache);
+
+  if (space < want) {
+    ring->producer.tail_cache = SPSC_LOAD_ACQUIRE(ring->consumer.tail);
+    space = ring->mask + 1 - (head - ring->producer.tail_cache);
+  }
+
+  return space;
+}
+
+/**
+ * Available elements as seen by consumer, refreshes cached head only if needed
+ */
+__STATIC_INLINE size_t spsc_ring_available(spsc_ring_t * ring, size_t tail, size_t want) {
+  size_t available = ring->consumer.head_cache - tail;
+
+  if (available < want) {
+    ring->consumer.head_cache = SPSC_LOAD_ACQUIRE(ring->producer.head);
+    available = ring->consumer.head_cache - tail;
+  }
+
+  return available;
+}
+
+/* Shared functions ========================================================= */
+error_t spsc_ring_init(spsc_ring_t * ring, void * buffer, size_t elem_size, size_t capacity) {
+  ASSERT_RETURN(ring && buffer, E_NULL);
+  ASSERT_RETURN(elem_size && capacity && (capacity & (capacity - 1)) == 0, E_INVAL);
+
+  ring->buffer = buffer;
+  ring->elem_size = elem_size;
+  ring->mask = capacity - 1;
+
+  return spsc_ring_reset(ring);
+}
+
+error_t spsc_ring_reset(spsc_ring_t * ring) {
+  ASSERT_RETURN(ring, E_NULL);
+
+  ring->producer.head = 0;
+  ring->producer.tail_cache = 0;
+  ring->consumer.tail = 0;
+  ring->consumer.head_cache = 0;
+
+  return E_OK;
+}
+
+error_t spsc_ring_push(spsc_ring_t * ring, const void * elem) {
+  ASSERT_RETURN(ring && elem, E_NULL);
+
+  size_t head = ring->producer.head;
+
+  if (!spsc_ring_space(ring, head, 1)) {
+    return E_OVERFLOW;
+  }
+
+  memcpy(ring->buffer + (head & ring->mask) * ring->elem_size, elem, ring->elem_size);
+
+  SPSC_STORE_RELEASE(ring->producer.head, head + 1);
+
+  return E_OK;
+}
+
+error_t spsc_ring_pop(spsc_ring_t * ring, void * elem) {
+  ASSERT_RETURN(ring && elem, E_NULL);
+
+  size_t tail = ring->consumer.tail;
+
+  if (!spsc_ring_available(ring, tail, 1)) {
+    return E_UNDERFLOW;
+  }
+
+  memcpy(elem, ring->buffer + (tail & ring->mask) * ring->elem_size, ring->elem_size);
+
+  SPSC_STORE_RELEASE(ring->consumer.tail, tail + 1);
+
+  return E_OK;
+}
+
+error_t spsc_ring_peek(spsc_ring_t * ring, void * elem) {
+  ASSERT_RETURN(ring && elem, E_NULL);
+
+  size_t tail = ring->consumer.tail;
+
+  if (!spsc_ring_available(ring, tail, 1)) {
+    return E_EMPTY;
+  }
+
+  memcpy(elem, ring->buffer + (tail & ring->mask) * ring->elem_size, ring->elem_size);
+
+  return E_OK;
+}
+
+size_t spsc_ring_push_batch(spsc_ring_t * ring, const void * elems, size_t count) {
+  ASSERT_RETURN(ring && elems, 0);
+
+  size_t head = ring->producer.head;
+  size_t space = spsc_ring_space(ring, head, count);
+
+  count = UTIL_MIN(count, space);
+
+  if (count) {
+    spsc_ring_copy_in(ring, head, elems, count);
+    SPSC_STORE_RELEASE(ring->producer.head, head + count);
+  }
+
+  return count;
+}
+
+size_t spsc_ring_pop_batch(spsc_ring_t * ring, void * elems, size_t count) {
+  ASSERT_RETURN(ring && elems, 0);
+
+  size_t tail = ring->consumer.tail;
+  size_t available = spsc_ring_available(ring, tail, count);
+
+  count = UTIL_MIN(count, available);
+
+  if (count) {
+    spsc_ring_copy_out(ring, tail, elems, count);
+    SPSC_STORE_RELEASE(ring->consumer.tail, tail + count);
+  }
+
+  return count;
+}
+
+size_t spsc_ring_size(spsc_ring_t * ring) {
+  if (!ring) {
+    return 0;
+  }
+
+  size_t tail = SPSC_LOAD_ACQUIRE(ring->consumer.tail);
+  size_t head = SPSC_LOAD_ACQUIRE(ring->producer.head);
+
+  return head - tail;
+}
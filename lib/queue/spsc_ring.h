@@ -0,0 +1,187 @@
+/** ========================================================================= *
+ *
+ * @file spsc_ring.h
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Lock-free single-producer/single-consumer ring buffer
+ *
+ * Meant for passing data from ISR to a task (or vice versa) without
+ * masking interrupts. Exactly one context may push, and exactly one
+ * context may pop.
+ *
+ * Head is written only by producer, tail only by consumer, both are free
+ * running and wrap with a mask, so capacity must be a power of 2 and all
+ * of it is usable. Indexes are published with release stores and read with
+ * acquire loads, so element data is always visible before the index.
+ * Every side also caches the other side's index, to touch the shared word
+ * only when the ring seems full/empty.
+ *
+ *  ========================================================================= */
+#pragma once
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include "util/compiler.h"
+#include "util/util.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* Defines ================================================================== */
+/**
+ * Alignment of producer & consumer parts of the ring
+ * Word is enough on MCUs without data cache, set to cache line size
+ * (e.g. 32 or 64) on cores with one, to avoid false sharing
+ */
+#ifndef SPSC_RING_INDEX_ALIGN
+#define SPSC_RING_INDEX_ALIGN sizeof(size_t)
+#endif
+
+/* Macros =================================================================== */
+/**
+ * Defines a ring
+ *
+ * @note Actually consists of 2 statements - declaration of buffer and ring
+ * @note spsc_ring_init can be used instead for explicit initialization
+ *
+ * @param name Ring name (variable)
+ * @param type Element type
+ * @param cap Capacity of ring, power of 2
+ */
+#define SPSC_RING_DEFINE(name, type, cap)                                       \
+  _Static_assert(((cap) & ((cap) - 1)) == 0 && (cap),                           \
+                 "SPSC ring capacity must be power of 2");                      \
+  type UTIL_CAT(name, _spsc_ring_buf)[cap];                                     \
+  spsc_ring_t name = {                                                          \
+    .buffer    = (uint8_t *) UTIL_CAT(name, _spsc_ring_buf),                    \
+    .elem_size = sizeof(type),                                                  \
+    .mask      = (cap) - 1,                                                     \
+  }
+
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * SPSC ring context
+ */
+typedef struct {
+  uint8_t * buffer;   /** Elements buffer */
+  size_t elem_size;   /** Element size */
+  size_t mask;        /** Capacity - 1 */
+
+  /**
+   * Written by producer only
+   */
+  struct {
+    size_t head;        /** Next element to write */
+    size_t tail_cache;  /** Last seen consumer tail */
+  } producer __ALIGN(SPSC_RING_INDEX_ALIGN);
+
+  /**
+   * Written by consumer only
+   */
+  struct {
+    size_t tail;        /** Next element to read */
+    size_t head_cache;  /** Last seen producer head */
+  } consumer __ALIGN(SPSC_RING_INDEX_ALIGN);
+} spsc_ring_t;
+
+/* Variables ================================================================ */
+/* Shared functions ========================================================= */
+/**
+ * Initializes ring
+ *
+ * @note SPSC_RING_DEFINE can be used instead for automatic buffer creation
+ *       and ring initialization
+ *
+ * @param ring Ring handle
+ * @param buffer Buffer for capacity elements
+ * @param elem_size Size of a single element
+ * @param capacity Capacity in elements, power of 2
+ */
+error_t spsc_ring_init(spsc_ring_t * ring, void * buffer, size_t elem_size, size_t capacity);
+
+/**
+ * Drops all elements
+ *
+ * @note Not safe to call while producer or consumer are active
+ *
+ * @param ring Ring handle
+ */
+error_t spsc_ring_reset(spsc_ring_t * ring);
+
+/**
+ * Push single element (producer)
+ *
+ * @param ring Ring handle
+ * @param elem Element to copy into the ring
+ * @retval E_OVERFLOW if ring is full
+ */
+error_t spsc_ring_push(spsc_ring_t * ring, const void * elem);
+
+/**
+ * Pop single element (consumer)
+ *
+ * @param ring Ring handle
+ * @param elem Element to copy out of the ring
+ * @retval E_UNDERFLOW if ring is empty
+ */
+error_t spsc_ring_pop(spsc_ring_t * ring, void * elem);
+
+/**
+ * Copy first element, without popping it (consumer)
+ *
+ * @param ring Ring handle
+ * @param elem Element to copy out of the ring
+ * @retval E_EMPTY if ring is empty
+ */
+error_t spsc_ring_peek(spsc_ring_t * ring, void * elem);
+
+/**
+ * Push up to count elements (producer)
+ *
+ * @note Index is published once, after all elements are copied
+ *
+ * @param ring Ring handle
+ * @param elems Elements to copy into the ring
+ * @param count Elements count
+ * @retval Elements pushed, less than count if ring got full
+ */
+size_t spsc_ring_push_batch(spsc_ring_t * ring, const void * elems, size_t count);
+
+/**
+ * Pop up to count elements (consumer)
+ *
+ * @param ring Ring handle
+ * @param elems Buffer for popped elements
+ * @param count Max elements to pop
+ * @retval Elements popped
+ */
+size_t spsc_ring_pop_batch(spsc_ring_t * ring, void * elems, size_t count);
+
+/**
+ * Returns elements count
+ *
+ * @note Exact only if called from producer or consumer, otherwise it's a
+ *       snapshot
+ *
+ * @param ring Ring handle
+ */
+size_t spsc_ring_size(spsc_ring_t * ring);
+
+/**
+ * Returns ring capacity in elements
+ *
+ * @param ring Ring handle
+ */
+__STATIC_INLINE size_t spsc_ring_capacity(spsc_ring_t * ring) {
+  return ring ? ring->mask + 1 : 0;
+}
+
+#ifdef __cplusplus
+}
+#endif
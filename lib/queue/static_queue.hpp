@@ -0,0 +1,147 @@
+/** ========================================================================= *
+ *
+ * @file static_queue.hpp
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Fixed capacity queue, storing elements by value (C++14)
+ *
+ * C++ counterpart of QUEUE_DEFINE_TYPED, same semantics and return values.
+ * Header-only, no heap usage, elements are moved in and out.
+ *
+ *  ========================================================================= */
+#pragma once
+
+/* Includes ================================================================= */
+#include "error/error.h"
+#include <stddef.h>
+
+namespace sdk {
+
+/* Types ==================================================================== */
+/**
+ * Fixed capacity queue
+ *
+ * @tparam T Element type, must be default constructible
+ * @tparam N Capacity
+ */
+template <typename T, size_t N>
+class StaticQueue {
+  static_assert(N > 0, "StaticQueue capacity must be non-zero");
+
+public:
+  constexpr StaticQueue() = default;
+
+  /**
+   * Drops all elements
+   */
+  void clear() {
+    m_size = 0;
+    m_head = 0;
+    m_tail = 0;
+  }
+
+  size_t size() const { return m_size; }
+
+  static constexpr size_t capacity() { return N; }
+
+  bool empty() const { return m_size == 0; }
+
+  bool full() const { return m_size == N; }
+
+  /**
+   * Push element to the back
+   *
+   * @retval E_OVERFLOW if queue is full
+   */
+  error_t push(const T & data) {
+    if (full()) {
+      return E_OVERFLOW;
+    }
+
+    m_elements[m_head] = data;
+    advance_head();
+
+    return E_OK;
+  }
+
+  error_t push(T && data) {
+    if (full()) {
+      return E_OVERFLOW;
+    }
+
+    m_elements[m_head] = static_cast<T &&>(data);
+    advance_head();
+
+    return E_OK;
+  }
+
+  /**
+   * Push element to the front
+   *
+   * @retval E_OVERFLOW if queue is full
+   */
+  error_t push_front(const T & data) {
+    if (full()) {
+      return E_OVERFLOW;
+    }
+
+    m_tail = m_tail ? m_tail - 1 : N - 1;
+    m_elements[m_tail] = data;
+    m_size++;
+
+    return E_OK;
+  }
+
+  /**
+   * Pop element from the front
+   *
+   * @retval E_UNDERFLOW if queue is empty
+   */
+  error_t pop(T & data) {
+    if (empty()) {
+      return E_UNDERFLOW;
+    }
+
+    data = static_cast<T &&>(m_elements[m_tail]);
+    m_tail = m_tail + 1 == N ? 0 : m_tail + 1;
+    m_size--;
+
+    return E_OK;
+  }
+
+  /**
+   * Copy element at the front, without popping it
+   *
+   * @retval E_EMPTY if queue is empty
+   */
+  error_t peek(T & data) const {
+    if (empty()) {
+      return E_EMPTY;
+    }
+
+    data = m_elements[m_tail];
+
+    return E_OK;
+  }
+
+  /**
+   * Access element at the front, queue must not be empty
+   */
+  T & front() { return m_elements[m_tail]; }
+
+  const T & front() const { return m_elements[m_tail]; }
+
+private:
+  void advance_head() {
+    m_head = m_head + 1 == N ? 0 : m_head + 1;
+    m_size++;
+  }
+
+  T m_elements[N] {};
+  size_t m_size = 0;
+  size_t m_head = 0;
+  size_t m_tail = 0;
+};
+
+} /* namespace sdk */
@@ -41,14 +41,19 @@ int8_t builtin_hexdump(shell_t * sh, uint8_t argc, const char ** argv) {
     return SHELL_FAIL;
   }
 
-  size_t size = vfs_get_file_size(file);
+  const uint8_t * data = NULL;
+  size_t size = 0;
+
+  if (vfs_map(file, &data, &size) != E_OK) {
+    log_error("Can't map file '%s'", argv[1]);
+    vfs_close(file);
+    return SHELL_FAIL;
+  }
 
   // TODO: Propper formatting (add address & colors + alterating bold/default fot data)
 
   for (size_t i = 0; i < size; ++i) {
-    uint8_t byte;
-    vfs_read(file, &byte, 1, VFS_READ_FLAG_NONE);
-    log_printf("%02x ", byte);
+    log_printf("%02x ", data[i]);
 
     if ((i+1) % SH_HEXDUMP_LINE == 0) {
       log_printf("\r\n");
@@ -42,30 +42,32 @@ int8_t builtin_ls(shell_t * sh, uint8_t argc, const char ** argv) {
 
   SHELL_ASSERT_REPORT_RETURN(folder, "Failed to open folder");
 
-  for (size_t i = 0; i < folder->folder.children->capacity; ++i) {
-    if (!folder->folder.children->nodes[i].used) {
-      continue;
-    }
+  vfs_node_t * node = vfs_get_file_node(folder);
+  vfs_node_t * iter = NULL;
 
-    vfs_file_t * iter = (vfs_file_t *) folder->folder.children->nodes[i].value;
+  if (node->head.type != VFS_FOLDER) {
+    vfs_close(folder);
+    log_error("Not a folder");
+    return SHELL_FAIL;
+  }
 
+  TABLE_FOREACH(node->folder.children, table_iter, iter) {
     if (long_format) {
       if (iter->head.type == VFS_FILE) {
-        log_printf("'%s' %s flags=0x%x cap=%u size=%u ofs=%u\r\n",
-          vfs_get_file_name(iter),
+        log_printf("'%s' %s flags=0x%x cap=%u size=%u\r\n",
+          vfs_get_node_name(iter),
           vfs_node_type_to_string(iter->head.type),
           iter->head.flags,
           iter->file.data.capacity,
-          iter->file.data.size,
-          iter->file.data.offset);
+          iter->file.data.size);
       } else {
         log_printf("'%s' %s flags=0x%x\r\n",
-          vfs_get_file_name(iter),
+          vfs_get_node_name(iter),
           vfs_node_type_to_string(iter->head.type),
           iter->head.flags);
       }
     } else {
-      log_printf("%s\r\n", vfs_get_file_name(iter));
+      log_printf("%s\r\n", vfs_get_node_name(iter));
     }
   }
 
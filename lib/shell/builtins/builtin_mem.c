@@ -33,6 +33,43 @@ extern uint32_t __os_heap_start;
 extern uint32_t __os_heap_end;
 
 /* Private functions ======================================================== */
+/**
+ * os_heap_walk callback for 'mem map'
+ */
+static void builtin_mem_map_cb(void * ctx, void * ptr, size_t size, bool used) {
+  (void) ctx;
+  log_printf("%p %6u %s\r\n", ptr, size, used ? "used" : "free");
+}
+
+__STATIC_INLINE int8_t builtin_mem_stats(os_heap_t * heap) {
+  os_heap_stats_t stats;
+
+  if (os_heap_stats(heap, &stats) != E_OK) {
+    log_error("Heap is corrupt");
+    return SHELL_FAIL;
+  }
+
+  log_printf("size          %u\r\n", stats.size);
+  log_printf("used          %u (peak %u)\r\n", stats.used, stats.peak);
+  log_printf("free          %u in %u blocks\r\n", stats.free, stats.free_blocks);
+  log_printf("used blocks   %u\r\n", stats.used_blocks);
+  log_printf("largest free  %u\r\n", stats.largest_free);
+  log_printf("fragmentation %u%%\r\n", stats.fragmentation);
+  log_printf("allocs        %u (failed %u)\r\n", stats.allocs, stats.fails);
+  log_printf("frees         %u\r\n", stats.frees);
+  log_printf("free blocks by size:\r\n");
+
+  for (size_t i = 0; i < OS_HEAP_STATS_HISTOGRAM_SIZE; ++i) {
+    if (i < OS_HEAP_STATS_HISTOGRAM_SIZE - 1) {
+      log_printf("  <%-6u %u\r\n", OS_HEAP_STATS_HISTOGRAM_MIN << i, stats.histogram[i]);
+    } else {
+      log_printf("  >=%-5u %u\r\n", OS_HEAP_STATS_HISTOGRAM_MIN << (i - 1), stats.histogram[i]);
+    }
+  }
+
+  return SHELL_OK;
+}
+
 /* Shared functions ========================================================= */
 int8_t builtin_mem(shell_t * sh, uint8_t argc, const char ** argv) {
   if (argc > 1) {
@@ -64,7 +101,20 @@ int8_t builtin_mem(shell_t * sh, uint8_t argc, const char ** argv) {
       return SHELL_OK;
     }
 
-    log_error("Usage: mem [read] ...");
+    if (!strcmp(argv[1], "stats")) {
+      return builtin_mem_stats(os_get_heap());
+    }
+
+    if (!strcmp(argv[1], "map")) {
+      if (os_heap_walk(os_get_heap(), builtin_mem_map_cb, NULL) != E_OK) {
+        log_error("Heap is corrupt");
+        return SHELL_FAIL;
+      }
+
+      return SHELL_OK;
+    }
+
+    log_error("Usage: mem [read|stats|map] ...");
     return SHELL_FAIL;
   }
 
@@ -19,6 +19,9 @@
 #define LOG_TAG shell
 
 /* Macros =================================================================== */
+/** Max tasks shown by 'task top' */
+#define SH_TASK_TOP_COUNT 8
+
 #define GET_TASK(name)                              \
     os_task_t * task = os_task_get(name);           \
     if (!task) {                                    \
@@ -41,14 +44,51 @@ __STATIC_INLINE os_signal_t string_to_signal(const char * name) {
 
 }
 
+#if OS_STAT_TRACE_TASK_HEAP
+/**
+ * Prints tasks holding most heap memory
+ */
+__STATIC_INLINE void builtin_task_top(void) {
+  os_task_t * top[SH_TASK_TOP_COUNT] = {0};
+  size_t count = 0;
+
+  os_task_t * task = NULL;
+
+  while (os_task_iter(&task)) {
+    size_t i = count < SH_TASK_TOP_COUNT ? count++ : SH_TASK_TOP_COUNT;
+
+    /* Insertion sort by heap usage, dropping the smallest one */
+    while (i > 0 && top[i - 1]->heap.used < task->heap.used) {
+      if (i < SH_TASK_TOP_COUNT) {
+        top[i] = top[i - 1];
+      }
+      i--;
+    }
+
+    if (i < SH_TASK_TOP_COUNT) {
+      top[i] = task;
+    }
+  }
+
+  log_printf("%-8s %8s %8s %8s\r\n", "task", "used", "peak", "quota");
+
+  for (size_t i = 0; i < count; ++i) {
+    log_printf(
+      "%-8s %8u %8u %8u\r\n",
+      top[i]->name, top[i]->heap.used, top[i]->heap.peak, top[i]->heap.quota
+    );
+  }
+}
+#endif
+
 /* Shared functions ========================================================= */
 int8_t builtin_task(shell_t * sh, uint8_t argc, const char ** argv) {
   if (
-      ( strcmp(argv[1], "list")   && argc < 2) ||
+      ( strcmp(argv[1], "list")   && strcmp(argv[1], "top") && argc < 2) ||
       (!strcmp(argv[1], "prio")   && argc < 3) ||
       (!strcmp(argv[1], "signal") && argc < 3)
   ) {
-    log_error("Usage: task list|pause|resume|kill|prio|signal [TASK] [SIGNAL|PRIO]");
+    log_error("Usage: task list|top|pause|resume|kill|prio|signal [TASK] [SIGNAL|PRIO]");
     return SHELL_FAIL;
   }
 
@@ -72,6 +112,13 @@ int8_t builtin_task(shell_t * sh, uint8_t argc, const char ** argv) {
       );
 #endif
     }
+  } else if (!strcmp(argv[1], "top")) {
+#if OS_STAT_TRACE_TASK_HEAP
+    builtin_task_top();
+#else
+    log_error("Task heap tracing is disabled (OS_STAT_TRACE_TASK_HEAP)");
+    return SHELL_FAIL;
+#endif
   } else if (!strcmp(argv[1], "pause")) {
     GET_TASK(argv[2]);
     os_task_pause(task);
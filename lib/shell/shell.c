@@ -19,14 +19,53 @@
 #define LOG_TAG      shell
 #define SHELL_PROMPT "# " /* Shell prompt (TODO: make it into variable) */
 
+#define SHELL_FNV_OFFSET 2166136261u
+#define SHELL_FNV_PRIME  16777619u
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /* Variables ================================================================ */
+#if USE_SHELL_COMMAND_INDEX
+/**
+ * Generated command index, stays NULL if project doesn't generate one
+ */
+extern const shell_command_index_t shell_command_index __WEAK;
+#endif
+
 /* Private functions ======================================================== */
 extern void shell_parse(shell_t * sh);
 
+#if USE_SHELL_COMMAND_INDEX
+/**
+ * Checks, whether index covers every command in .sh_cmd section
+ *
+ * Commands, declared in a way generator didn't see, are missing from the
+ * index, in that case a miss in the index must be confirmed by linear search
+ */
+static bool shell_command_index_complete(void) {
+  static int8_t complete = -1;
+
+  if (complete < 0) {
+    size_t indexed = 0;
+    size_t linked = 0;
+
+    for (size_t i = 0; i < shell_command_index.size; ++i) {
+      indexed += shell_command_index.commands[i] != NULL;
+    }
+
+    SHELL_ITER_COMMANDS(cmd) {
+      linked++;
+    }
+
+    complete = indexed == linked;
+  }
+
+  return complete;
+}
+#endif
+
 __STATIC_INLINE void shell_reset_buffers(shell_t * sh) {
   tty_line_reset(&sh->line);
 
@@ -80,18 +119,16 @@ static error_t shell_exec(shell_t * sh, int8_t * result) {
   }
 #endif
 
-  // Look for command handler by comparing name of each command to
-  // the first token
-  SHELL_ITER_COMMANDS(cmd) {
-    if (!strcmp(sh->args.buf[0], cmd->name)) {
-      *result = cmd->handler(sh, sh->args.size, sh->args.buf);
+  const shell_command_t * cmd = shell_find_command(sh->args.buf[0]);
 
-      if (sh->flags & SHELL_FLAG_ECHO_RES) {
-        log_printf("=%d\r\n", *result);
-      }
+  if (cmd) {
+    *result = cmd->handler(sh, sh->args.size, sh->args.buf);
 
-      return E_OK;
+    if (sh->flags & SHELL_FLAG_ECHO_RES) {
+      log_printf("=%d\r\n", *result);
     }
+
+    return E_OK;
   }
 
   log_error("Command '%s' not found", sh->args.buf[0]);
@@ -211,3 +248,44 @@ int8_t shell_execute(shell_t * sh, const char * command) {
 
   return result;
 }
+
+const shell_command_t * shell_find_command(const char * name) {
+  ASSERT_RETURN(name, NULL);
+
+#if USE_SHELL_COMMAND_INDEX
+  if (&shell_command_index && shell_command_index.size) {
+    const shell_command_index_t * index = &shell_command_index;
+
+    uint16_t seed = index->seeds[shell_command_hash(name, 0) % index->buckets];
+    const shell_command_t * cmd = index->commands[shell_command_hash(name, seed) % index->size];
+
+    if (cmd && !strcmp(cmd->name, name)) {
+      return cmd;
+    }
+
+    if (shell_command_index_complete()) {
+      return NULL;
+    }
+  }
+#endif
+
+  // Look for command by comparing name of each command
+  SHELL_ITER_COMMANDS(cmd) {
+    if (!strcmp(name, cmd->name)) {
+      return cmd;
+    }
+  }
+
+  return NULL;
+}
+
+uint32_t shell_command_hash(const char * name, uint32_t seed) {
+  uint32_t hash = SHELL_FNV_OFFSET ^ seed;
+
+  while (*name) {
+    hash ^= (uint8_t) *name++;
+    hash *= SHELL_FNV_PRIME;
+  }
+
+  return hash ^ (hash >> 16);
+}
@@ -76,6 +76,15 @@ extern "C" {
 #define SHELL_HISTORY_BUFFER_SIZE   4
 #endif
 
+/**
+ * Use build-time generated perfect hash index for command lookup, if
+ * project provides it (see project_add_shell_command_index in
+ * toolchain/project.cmake), falls back to linear search otherwise
+ */
+#ifndef USE_SHELL_COMMAND_INDEX
+#define USE_SHELL_COMMAND_INDEX     1
+#endif
+
 /**
  * Successful result
  */
@@ -156,6 +165,21 @@ typedef struct {
   const char * help;
 } shell_command_t;
 
+/**
+ * Shell command index (minimal perfect hash of command names)
+ *
+ * Command with given name can only be at
+ *   commands[hash(name, seeds[hash(name, 0) % buckets]) % size]
+ *
+ * Generated by toolchain/scripts/shell_cmd_index.py
+ */
+typedef struct {
+  const uint16_t * seeds;                   /** Hash seed per bucket */
+  const shell_command_t * const * commands; /** NULL if command isn't linked */
+  uint16_t buckets;
+  uint16_t size;
+} shell_command_index_t;
+
 /**
  * Shell context
  */
@@ -261,6 +285,24 @@ error_t shell_process(shell_t * sh);
  */
 int8_t shell_execute(shell_t * sh, const char * command);
 
+/**
+ * Finds command by name
+ *
+ * @param name Command name
+ * @retval Command or NULL if not found
+ */
+const shell_command_t * shell_find_command(const char * name);
+
+/**
+ * Hash of command name, used by command index (seeded FNV-1a)
+ *
+ * @note Must match hash in toolchain/scripts/shell_cmd_index.py
+ *
+ * @param name Command name
+ * @param seed Hash seed
+ */
+uint32_t shell_command_hash(const char * name, uint32_t seed);
+
 #if USE_SHELL_HISTORY
 /**
  * Reset shell history
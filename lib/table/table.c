@@ -11,42 +11,158 @@
 /* Includes ================================================================= */
 #include "table/table.h"
 #include "error/assertion.h"
+#include <string.h>
 
 /* Defines ================================================================== */
+#define TABLE_FNV_OFFSET  2166136261u
+#define TABLE_FNV_PRIME   16777619u
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
 /* Variables ================================================================ */
 /* Private functions ======================================================== */
-__STATIC_INLINE table_node_t * table_find_node(table_t * table, table_hash_t hash) {
-  ASSERT_RETURN(table, NULL);
+__STATIC_INLINE size_t table_next_index(table_t * table, size_t index) {
+  return index + 1 == table->capacity ? 0 : index + 1;
+}
 
-  table_node_t * node = &table->nodes[hash % table->capacity];
+__STATIC_INLINE bool table_node_match(table_t * table, table_node_t * node, table_hash_t hash, const void * key) {
+  return node->hash == hash && (!key || !table->key_match || table->key_match(node->value, key));
+}
+
+/**
+ * Walks probe chain of hash until matching or empty node
+ *
+ * If free is not NULL, first empty or deleted node met on the way is
+ * placed there (or NULL if table is full)
+ *
+ * @retval Matching node or NULL
+ */
+__STATIC_INLINE table_node_t * table_probe(table_t * table, table_hash_t hash, const void * key, table_node_t ** free) {
+  size_t index = hash % table->capacity;
+
+  if (free) {
+    *free = NULL;
+  }
 
   for (size_t i = 0; i < table->capacity; ++i) {
-    if (node->used && node->hash == hash) {
-      return node;
+    table_node_t * node = &table->nodes[index];
+
+    if (node->state == TABLE_NODE_USED) {
+      if (table_node_match(table, node, hash, key)) {
+        return node;
+      }
+    } else {
+      if (free && !*free) {
+        *free = node;
+      }
+
+      if (node->state == TABLE_NODE_EMPTY) {
+        break;
+      }
     }
-    node = &node[i];
+
+    index = table_next_index(table, index);
   }
 
   return NULL;
 }
 
+/**
+ * Turns node into a tombstone
+ *
+ * If the next node is empty, no probe chain continues past this one, so
+ * it and tombstones right before it are turned back into empty nodes
+ */
+__STATIC_INLINE void table_node_delete(table_t * table, table_node_t * node) {
+  size_t index = node - table->nodes;
+
+  node->state = TABLE_NODE_DELETED;
+  table->size--;
+  table->tombstones++;
+
+  if (!table->size) {
+    table_clear(table);
+    return;
+  }
+
+  if (table->nodes[table_next_index(table, index)].state != TABLE_NODE_EMPTY) {
+    return;
+  }
+
+  while (table->nodes[index].state == TABLE_NODE_DELETED) {
+    table->nodes[index].state = TABLE_NODE_EMPTY;
+    table->tombstones--;
+    index = index ? index - 1 : table->capacity - 1;
+  }
+}
+
 /* Shared functions ========================================================= */
 error_t table_init(table_t * table, table_node_t * nodes_buffer, size_t cap) {
   ASSERT_RETURN(table && nodes_buffer && cap, E_NULL);
 
   table->nodes = nodes_buffer;
   table->capacity = cap;
+  table->key_match = NULL;
+
+  return table_clear(table);
+}
+
+error_t table_deinit(table_t * table) {
+  return table_clear(table);
+}
+
+error_t table_set_key_match(table_t * table, table_key_match_fn_t key_match) {
+  ASSERT_RETURN(table, E_NULL);
+
+  table->key_match = key_match;
+
+  return E_OK;
+}
+
+error_t table_clear(table_t * table) {
+  ASSERT_RETURN(table, E_NULL);
+
+  memset(table->nodes, 0, sizeof(table_node_t) * table->capacity);
   table->size = 0;
+  table->tombstones = 0;
 
   return E_OK;
 }
 
-error_t table_deinit(table_t * table) {
-  return E_NOTIMPL;
+error_t table_resize(table_t * table, table_node_t * nodes_buffer, size_t cap) {
+  ASSERT_RETURN(table && nodes_buffer, E_NULL);
+  ASSERT_RETURN(cap && cap >= table->size && nodes_buffer != table->nodes, E_INVAL);
+
+  memset(nodes_buffer, 0, sizeof(table_node_t) * cap);
+
+  for (size_t i = 0; i < table->capacity; ++i) {
+    table_node_t * node = &table->nodes[i];
+
+    if (node->state != TABLE_NODE_USED) {
+      continue;
+    }
+
+    size_t index = node->hash % cap;
+
+    while (nodes_buffer[index].state != TABLE_NODE_EMPTY) {
+      index = index + 1 == cap ? 0 : index + 1;
+    }
+
+    nodes_buffer[index] = *node;
+  }
+
+  table->nodes = nodes_buffer;
+  table->capacity = cap;
+  table->tombstones = 0;
+
+  return E_OK;
+}
+
+bool table_should_grow(table_t * table) {
+  ASSERT_RETURN(table, false);
+  return (table->size + 1) * 100 > table->capacity * TABLE_GROW_LOAD;
 }
 
 size_t table_get_capacity(table_t * table) {
@@ -60,66 +176,97 @@ size_t table_get_size(table_t * table) {
 }
 
 error_t table_add(table_t * table, table_hash_t hash, void * value) {
+  return table_add_key(table, hash, NULL, value);
+}
+
+error_t table_remove(table_t * table, table_hash_t hash) {
+  return table_remove_key(table, hash, NULL);
+}
+
+void * table_find(table_t * table, table_hash_t hash) {
+  return table_find_key(table, hash, NULL);
+}
+
+error_t table_add_key(table_t * table, table_hash_t hash, const void * key, void * value) {
   ASSERT_RETURN(table, E_NULL);
 
-  size_t index = hash % table->capacity;
-  table_node_t * node = &table->nodes[index];
-
-  for (size_t i = index; i < table->capacity; ++i) {
-    if (!node->used) {
-      node->hash = hash;
-      node->value = value;
-      node->used = true;
-      table->size++;
-      return E_OK;
-    }
-    node = &node[i];
+  table_node_t * node = NULL;
+
+  if (table_probe(table, hash, key, &node)) {
+    return E_INUSE;
+  }
+
+  if (!node) {
+    return E_NOMEM;
   }
 
-  return E_NOMEM;
+  if (node->state == TABLE_NODE_DELETED) {
+    table->tombstones--;
+  }
+
+  node->hash = hash;
+  node->value = value;
+  node->state = TABLE_NODE_USED;
+  table->size++;
+
+  return E_OK;
 }
 
-error_t table_remove(table_t * table, table_hash_t hash) {
+error_t table_remove_key(table_t * table, table_hash_t hash, const void * key) {
   ASSERT_RETURN(table, E_NULL);
 
-  table_node_t * node = table_find_node(table, hash);
+  table_node_t * node = table_probe(table, hash, key, NULL);
 
   if (!node) {
     return E_NOTFOUND;
   }
 
-  node->used = false;
-  table->size--;
+  table_node_delete(table, node);
 
   return E_OK;
 }
 
-void * table_find(table_t * table, table_hash_t hash) {
+void * table_find_key(table_t * table, table_hash_t hash, const void * key) {
   ASSERT_RETURN(table, NULL);
 
-  table_node_t * node = table_find_node(table, hash);
+  table_node_t * node = table_probe(table, hash, key, NULL);
 
   return node ? node->value : NULL;
 }
 
 table_hash_t table_str_hash(const char * str) {
-  table_hash_t result = 7;
+  table_hash_t result = TABLE_FNV_OFFSET;
 
   while (*str) {
-    result = result * 31 + *str++;
+    result ^= (uint8_t) *str++;
+    result *= TABLE_FNV_PRIME;
   }
 
   return result;
 }
 
 error_t table_add_str(table_t * table, const char * str, void * data) {
-  return table_add(table, table_str_hash(str), data);
+  return table_add_key(table, table_str_hash(str), str, data);
 }
 
 error_t table_remove_str(table_t * table, const char * str) {
-  return table_remove(table, table_str_hash(str));
+  return table_remove_key(table, table_str_hash(str), str);
 }
 
 void * table_find_str(table_t * table, const char * str) {
-  return table_find(table, table_str_hash(str));
+  return table_find_key(table, table_str_hash(str), str);
+}
+
+void * table_next(table_t * table, table_iter_t * iter) {
+  ASSERT_RETURN(table && iter, NULL);
+
+  while (iter->index < table->capacity) {
+    table_node_t * node = &table->nodes[iter->index++];
+
+    if (node->state == TABLE_NODE_USED) {
+      return node->value;
+    }
+  }
+
+  return NULL;
 }
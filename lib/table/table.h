@@ -6,6 +6,15 @@
  *
  * @brief Hash table data structure
  *
+ * Open addressing with linear probing over a caller provided node buffer.
+ * Every node stores full 32-bit hash and value. If table has a key match
+ * callback, entries with equal hash are also compared by key, so colliding
+ * keys don't alias each other. Removed entries become tombstones, which
+ * keep probe chains intact, and are reused by later inserts.
+ *
+ * Table doesn't allocate, but can be moved to a bigger buffer with
+ * table_resize.
+ *
  *  ========================================================================= */
 #pragma once
 
@@ -16,11 +25,19 @@ extern "C" {
 /* Includes ================================================================= */
 #include "error/error.h"
 #include "util/compiler.h"
+#include "util/util.h"
 #include <stdbool.h>
 #include <stdint.h>
 #include <stddef.h>
 
 /* Defines ================================================================== */
+/**
+ * Load factor (in %), after which table_should_grow returns true
+ */
+#ifndef TABLE_GROW_LOAD
+#define TABLE_GROW_LOAD 75
+#endif
+
 /* Macros =================================================================== */
 /**
  * Defines table context with name and capacity
@@ -36,25 +53,62 @@ extern "C" {
     .size = 0                                         \
   }
 
+/**
+ * Iterates over all values in the table
+ *
+ * @note Removing current value while iterating is allowed, adding is not
+ *
+ * @param __table Pointer to table context
+ * @param __iter Name for iterator variable
+ * @param __value Value pointer variable (must be declared outside)
+ */
+#define TABLE_FOREACH(__table, __iter, __value)                                 \
+  for (table_iter_t __iter = {0}; ((__value) = table_next(__table, &__iter)); )
+
 /* Enums ==================================================================== */
+/**
+ * State of a table node
+ */
+typedef enum {
+  TABLE_NODE_EMPTY = 0,   /** Never used, terminates probing */
+  TABLE_NODE_USED,        /** Holds a value */
+  TABLE_NODE_DELETED,     /** Tombstone, skipped by lookup, reused by add */
+} table_node_state_t;
+
 /* Types ==================================================================== */
 /** Typedef for a hash type */
 typedef uint32_t table_hash_t;
 
+/**
+ * Key match callback
+ *
+ * @param value Value stored in the table
+ * @param key Key passed to table_*_key/table_*_str
+ * @retval true if value has this key
+ */
+typedef bool (*table_key_match_fn_t)(const void * value, const void * key);
+
 /** Node for a hash table */
 typedef __PACKED_STRUCT {
   table_hash_t  hash;
   void *        value;
-  bool          used;
+  uint8_t       state;  /** table_node_state_t */
 } table_node_t;
 
 /** Hash table context */
 typedef struct {
-  table_node_t * nodes;
-  size_t         capacity;
-  size_t         size;
+  table_node_t *       nodes;
+  size_t               capacity;
+  size_t               size;        /** Used nodes */
+  size_t               tombstones;  /** Deleted nodes */
+  table_key_match_fn_t key_match;   /** Optional, hash-only matching if NULL */
 } table_t;
 
+/** Table iterator */
+typedef struct {
+  size_t index;
+} table_iter_t;
+
 /* Variables ================================================================ */
 /* Shared functions ========================================================= */
 /**
@@ -67,12 +121,48 @@ typedef struct {
 error_t table_init(table_t * table, table_node_t * nodes_buffer, size_t cap);
 
 /**
- * Deinitializes a table
+ * Deinitializes a table, dropping all values
  *
  * @param table Pointer to table context
  */
 error_t table_deinit(table_t * table);
 
+/**
+ * Sets key match callback
+ *
+ * @note Must be set before anything is added
+ *
+ * @param table Pointer to table context
+ * @param key_match Callback
+ */
+error_t table_set_key_match(table_t * table, table_key_match_fn_t key_match);
+
+/**
+ * Drops all values
+ *
+ * @param table Pointer to table context
+ */
+error_t table_clear(table_t * table);
+
+/**
+ * Moves table contents to a new node buffer, dropping tombstones
+ *
+ * @note Old buffer is not touched and can be freed after the call
+ *
+ * @param table Pointer to table context
+ * @param nodes_buffer New buffer, must not overlap with current one
+ * @param cap Capacity of the new buffer, not less than table size
+ */
+error_t table_resize(table_t * table, table_node_t * nodes_buffer, size_t cap);
+
+/**
+ * Checks whether table load, counting one more value, exceeds
+ * TABLE_GROW_LOAD, so it should be resized before next add
+ *
+ * @param table Pointer to table context
+ */
+bool table_should_grow(table_t * table);
+
 /**
  * Returns table capacity
  *
@@ -93,6 +183,8 @@ size_t table_get_size(table_t * table);
  * @param table Pointer to table context
  * @param hash Hash of the value
  * @param value to add
+ * @retval E_INUSE if value with this hash already exists
+ * @retval E_NOMEM if table is full
  */
 error_t table_add(table_t * table, table_hash_t hash, void * value);
 
@@ -113,7 +205,37 @@ error_t table_remove(table_t * table, table_hash_t hash);
 void * table_find(table_t * table, table_hash_t hash);
 
 /**
- * Returns a hash for a string
+ * Adds a value to the table by hash and key
+ *
+ * @param table Pointer to table context
+ * @param hash Hash of the key
+ * @param key Key, compared with key_match callback
+ * @param value to add
+ * @retval E_INUSE if value with this key already exists
+ * @retval E_NOMEM if table is full
+ */
+error_t table_add_key(table_t * table, table_hash_t hash, const void * key, void * value);
+
+/**
+ * Removes value from the table by hash and key
+ *
+ * @param table Pointer to table context
+ * @param hash Hash of the key
+ * @param key Key, compared with key_match callback
+ */
+error_t table_remove_key(table_t * table, table_hash_t hash, const void * key);
+
+/**
+ * Searches the table for value by hash and key
+ *
+ * @param table Pointer to table context
+ * @param hash Hash of the key
+ * @param key Key, compared with key_match callback
+ */
+void * table_find_key(table_t * table, table_hash_t hash, const void * key);
+
+/**
+ * Returns a hash for a string (FNV-1a)
  *
  * @param str String pointer
  */
@@ -144,6 +266,15 @@ error_t table_remove_str(table_t * table, const char * str);
  */
 void * table_find_str(table_t * table, const char * str);
 
+/**
+ * Returns next value, used by TABLE_FOREACH
+ *
+ * @param table Pointer to table context
+ * @param iter Iterator, zero-initialized before first call
+ * @retval Value or NULL, if there are no more values
+ */
+void * table_next(table_t * table, table_iter_t * iter);
+
 #ifdef __cplusplus
 }
 #endif
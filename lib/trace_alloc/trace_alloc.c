@@ -4,7 +4,7 @@
  * @date 10-03-2025
  * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
  *
- * @brief 
+ * @brief Allocator trace implementation
  *
  *  ========================================================================= */
 
@@ -13,11 +13,15 @@
 #include "os/alloc/alloc.h"
 #include "tty/ansi.h"
 #include "log/log.h"
+#include <string.h>
 
 /* Defines ================================================================== */
 #define TRACE_ALLOC_LOC_FMT                                                     \
   ANSI_COLOR_FG_CYAN "%s" ANSI_TEXT_RESET ":" ANSI_COLOR_FG_MAGENTA "%zu" ANSI_TEXT_RESET
 
+/** Max live allocations, keeps probe sequences short */
+#define TRACE_ALLOC_LOAD_MAX  (TRACE_ALLOC_BUF_SIZE / 4 * 3)
+
 /* Macros =================================================================== */
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
@@ -27,98 +31,300 @@
 static trace_alloc_ctx_t trace_alloc_instance;
 #endif
 
+_Static_assert((TRACE_ALLOC_BUF_SIZE & (TRACE_ALLOC_BUF_SIZE - 1)) == 0,
+               "TRACE_ALLOC_BUF_SIZE must be power of 2");
+_Static_assert((TRACE_ALLOC_SITE_COUNT & (TRACE_ALLOC_SITE_COUNT - 1)) == 0,
+               "TRACE_ALLOC_SITE_COUNT must be power of 2");
+_Static_assert(TRACE_ALLOC_SITE_COUNT < TRACE_ALLOC_SITE_NONE,
+               "TRACE_ALLOC_SITE_COUNT is too big");
+
 /* Private functions ======================================================== */
-/* Shared functions ========================================================= */
-void trace_alloc_start(trace_alloc_ctx_t * ctx) {
+__STATIC_INLINE size_t trace_alloc_hash(uintptr_t value) {
+  /* Fibonacci hashing, low bits of pointers are mostly zero */
+  return (size_t) ((value >> 3) * 2654435761u);
+}
+
+__STATIC_INLINE size_t trace_alloc_home(void * ptr) {
+  return trace_alloc_hash((uintptr_t) ptr) & (TRACE_ALLOC_BUF_SIZE - 1);
+}
+
+/**
+ * Finds index slot of ptr, or empty slot it would be inserted to
+ */
+static size_t trace_alloc_lookup(trace_alloc_ctx_t * ctx, void * ptr) {
+  size_t i = trace_alloc_home(ptr);
+
+  while (ctx->allocations[i].ptr && ctx->allocations[i].ptr != ptr) {
+    i = (i + 1) & (TRACE_ALLOC_BUF_SIZE - 1);
+  }
+
+  return i;
+}
+
+/**
+ * Removes record at slot i, shifting following records of the same probe
+ * sequence back, so no tombstones are needed
+ */
+static void trace_alloc_remove(trace_alloc_ctx_t * ctx, size_t i) {
+  size_t j = i;
+
+  for (;;) {
+    j = (j + 1) & (TRACE_ALLOC_BUF_SIZE - 1);
+
+    if (!ctx->allocations[j].ptr) {
+      break;
+    }
+
+    size_t k = trace_alloc_home(ctx->allocations[j].ptr);
+
+    /* Record at j is reachable from its home without passing i, keep it */
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+      continue;
+    }
+
+    ctx->allocations[i] = ctx->allocations[j];
+    i = j;
+  }
+
+  ctx->allocations[i].ptr = NULL;
+}
+
+/**
+ * Finds or creates call site
+ */
+static uint16_t trace_alloc_site(trace_alloc_ctx_t * ctx, const char * fn, size_t line) {
+  size_t i = trace_alloc_hash((uintptr_t) fn ^ (line << 4)) & (TRACE_ALLOC_SITE_COUNT - 1);
+
+  for (size_t n = 0; n < TRACE_ALLOC_SITE_COUNT; ++n) {
+    trace_alloc_site_t * site = &ctx->sites[i];
+
+    if (!site->location.fn) {
+      site->location.fn = fn;
+      site->location.line = line;
+      return (uint16_t) i;
+    }
+
+    if (site->location.fn == fn && site->location.line == line) {
+      return (uint16_t) i;
+    }
+
+    i = (i + 1) & (TRACE_ALLOC_SITE_COUNT - 1);
+  }
+
+  return TRACE_ALLOC_SITE_NONE;
+}
+
+__STATIC_INLINE void trace_alloc_event(
+    trace_alloc_ctx_t * ctx, trace_alloc_event_type_t type, uint16_t site, void * ptr, size_t size
+) {
+#if TRACE_ALLOC_USE_EVENTS
+  if (ctx->event_cb) {
+    trace_alloc_event_t event = {
+      .type = (uint8_t) type,
+      .site = site,
+      .seq = ctx->seq,
+      .ptr = (uint32_t) (uintptr_t) ptr,
+      .size = (uint32_t) size,
+    };
+
+    ctx->event_cb(ctx->event_user, &event);
+  }
+#endif
+
+  ctx->seq++;
+}
+
+__STATIC_INLINE trace_alloc_ctx_t * trace_alloc_resolve(trace_alloc_ctx_t * ctx) {
 #if TRACE_ALLOC_USE_SINGLE_INSTANCE
   if (!ctx) {
     ctx = &trace_alloc_instance;
   }
 #endif
 
+  return ctx;
+}
+
+/**
+ * Prints call sites with live allocations, sorted by live bytes
+ */
+static void trace_alloc_print_sites(trace_alloc_ctx_t * ctx, const char * what) {
+  uint16_t order[TRACE_ALLOC_SITE_COUNT];
+  size_t count = 0;
+
+  /* Insertion sort by live bytes, site table is small */
+  for (size_t i = 0; i < TRACE_ALLOC_SITE_COUNT; ++i) {
+    if (!ctx->sites[i].count) {
+      continue;
+    }
+
+    size_t j = count++;
+
+    while (j && ctx->sites[order[j - 1]].bytes < ctx->sites[i].bytes) {
+      order[j] = order[j - 1];
+      j--;
+    }
+
+    order[j] = (uint16_t) i;
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    trace_alloc_site_t * site = &ctx->sites[order[i]];
+
+    TRACE_ALLOC_PORT_LOG(
+      ANSI_TEXT_BOLD "trace_alloc" ANSI_TEXT_RESET ": "
+        ANSI_COLOR_FG_RED "%s" ANSI_TEXT_RESET " %zu bytes in %zu blocks (of %zu, peak %zu bytes) at "
+        TRACE_ALLOC_LOC_FMT "\n",
+      what, site->bytes, site->count, site->allocs, site->peak,
+      site->location.fn, site->location.line
+    );
+  }
+}
+
+/**
+ * Drops index record of ptr and updates its call site
+ */
+static void trace_free_track(trace_alloc_ctx_t * ctx, void * ptr, const char * fn, size_t line) {
+  size_t i = trace_alloc_lookup(ctx, ptr);
+  trace_alloc_t * record = &ctx->allocations[i];
+
+  if (!record->ptr) {
+    ctx->unknown++;
+    trace_alloc_event(ctx, TRACE_ALLOC_EVENT_FREE_UNKNOWN, TRACE_ALLOC_SITE_NONE, ptr, 0);
+    return;
+  }
+
+  uint16_t site_idx = record->site;
+  size_t size = record->size;
+
+  if (site_idx != TRACE_ALLOC_SITE_NONE) {
+    ctx->sites[site_idx].count--;
+    ctx->sites[site_idx].bytes -= size;
+  }
+
+  trace_alloc_event(ctx, TRACE_ALLOC_EVENT_FREE, site_idx, ptr, size);
+
+#if TRACE_ALLOC_USE_LOG
+  TRACE_ALLOC_PORT_LOG(
+    ANSI_TEXT_BOLD "free_checked" ANSI_TEXT_RESET ": %p %zu at "
+      TRACE_ALLOC_LOC_FMT " (allocated at " TRACE_ALLOC_LOC_FMT ")\n",
+    ptr, size, fn, line,
+    site_idx != TRACE_ALLOC_SITE_NONE ? ctx->sites[site_idx].location.fn : "?",
+    site_idx != TRACE_ALLOC_SITE_NONE ? ctx->sites[site_idx].location.line : 0
+  );
+#else
+  (void) fn;
+  (void) line;
+#endif
+
+  trace_alloc_remove(ctx, i);
+  ctx->count--;
+}
+
+/* Shared functions ========================================================= */
+void trace_alloc_start(trace_alloc_ctx_t * ctx) {
+  ctx = trace_alloc_resolve(ctx);
+
   memset(ctx, 0, sizeof(trace_alloc_ctx_t));
 
   ctx->enabled = true;
 }
 
 size_t trace_alloc_end(trace_alloc_ctx_t * ctx) {
-#if TRACE_ALLOC_USE_SINGLE_INSTANCE
-  if (!ctx) {
-    ctx = &trace_alloc_instance;
-  }
-#endif
+  ctx = trace_alloc_resolve(ctx);
 
   ctx->enabled = false;
 
-  size_t leaks = 0;
+  if (ctx->dropped || ctx->unknown) {
+    TRACE_ALLOC_PORT_LOG(
+      ANSI_TEXT_BOLD "trace_alloc" ANSI_TEXT_RESET ": %zu allocations not traced, %zu unknown frees\n",
+      ctx->dropped, ctx->unknown
+    );
+  }
 
-  for (size_t i = 0; i < TRACE_ALLOC_BUF_SIZE; ++i) {
-    if (ctx->allocations[i].allocated) {
-      TRACE_ALLOC_PORT_LOG(
-        ANSI_TEXT_BOLD "malloc_checked" ANSI_TEXT_RESET ": "
-          ANSI_COLOR_FG_RED "leak" ANSI_TEXT_RESET " %p %zu (allocated at "
-          TRACE_ALLOC_LOC_FMT ")\n",
-        ctx->allocations[i].info.ptr, ctx->allocations[i].info.size,
-        ctx->allocations[i].location.fn, ctx->allocations[i].location.line
-      );
+  trace_alloc_print_sites(ctx, "leak");
 
-      leaks++;
-    }
-  }
+  return ctx->count;
+}
 
-  return leaks;
+size_t trace_alloc_report(trace_alloc_ctx_t * ctx) {
+  ctx = trace_alloc_resolve(ctx);
+  trace_alloc_print_sites(ctx, "live");
+  return ctx->count;
 }
 
+#if TRACE_ALLOC_USE_EVENTS
+void trace_alloc_set_event_cb(trace_alloc_ctx_t * ctx, trace_alloc_event_cb_t cb, void * user) {
+  ctx = trace_alloc_resolve(ctx);
+
+  ctx->event_cb = cb;
+  ctx->event_user = user;
+}
+#endif
+
 void * trace_alloc_impl(size_t size, const char * fn, size_t line) {
   trace_alloc_ctx_t * ctx = trace_alloc_get_instance();
 
   void * ptr = TRACE_ALLOC_PORT_ALLOC_FN(size);
 
-  if (ctx->enabled) {
-    for (size_t i = 0; i < TRACE_ALLOC_BUF_SIZE; ++i) {
-      if (!ctx->allocations[i].allocated) {
-        ctx->allocations[i].info.ptr = ptr;
-        ctx->allocations[i].info.size = size;
-        ctx->allocations[i].location.fn = fn;
-        ctx->allocations[i].location.line = line;
-        ctx->allocations[i].allocated = true;
-
-        TRACE_ALLOC_PORT_LOG(
-          ANSI_TEXT_BOLD "malloc_checked" ANSI_TEXT_RESET ": %p %zu at "
-            TRACE_ALLOC_LOC_FMT "\n",
-          ptr, size, fn, line
-        );
-
-        break;
-      }
+  if (!ctx->enabled) {
+    return ptr;
+  }
+
+  uint16_t site_idx = trace_alloc_site(ctx, fn, line);
+
+  if (!ptr) {
+    trace_alloc_event(ctx, TRACE_ALLOC_EVENT_ALLOC_FAIL, site_idx, NULL, size);
+    return ptr;
+  }
+
+  if (ctx->count >= TRACE_ALLOC_LOAD_MAX) {
+    ctx->dropped++;
+    trace_alloc_event(ctx, TRACE_ALLOC_EVENT_DROP, site_idx, ptr, size);
+    return ptr;
+  }
+
+  trace_alloc_t * record = &ctx->allocations[trace_alloc_lookup(ctx, ptr)];
+
+  record->ptr = ptr;
+  record->size = (uint32_t) size;
+  record->site = site_idx;
+
+  ctx->count++;
+
+  if (site_idx != TRACE_ALLOC_SITE_NONE) {
+    trace_alloc_site_t * site = &ctx->sites[site_idx];
+
+    site->allocs++;
+    site->count++;
+    site->bytes += size;
+
+    if (site->bytes > site->peak) {
+      site->peak = site->bytes;
     }
   }
 
+  trace_alloc_event(ctx, TRACE_ALLOC_EVENT_ALLOC, site_idx, ptr, size);
+
+#if TRACE_ALLOC_USE_LOG
+  TRACE_ALLOC_PORT_LOG(
+    ANSI_TEXT_BOLD "malloc_checked" ANSI_TEXT_RESET ": %p %zu at "
+      TRACE_ALLOC_LOC_FMT "\n",
+    ptr, size, fn, line
+  );
+#endif
+
   return ptr;
 }
 
 void trace_free_impl(void * ptr, const char * fn, size_t line) {
   trace_alloc_ctx_t * ctx = trace_alloc_get_instance();
 
-  TRACE_ALLOC_PORT_FREE_FN(ptr);
-
-  if (ctx->enabled) {
-    for (size_t i = 0; i < TRACE_ALLOC_BUF_SIZE; ++i) {
-      if (ctx->allocations[i].allocated && ctx->allocations[i].info.ptr == ptr) {
-        ctx->allocations[i].allocated = false;
-
-        TRACE_ALLOC_PORT_LOG(
-          ANSI_TEXT_BOLD "free_checked" ANSI_TEXT_RESET ": %p %zu at "
-            TRACE_ALLOC_LOC_FMT " (allocated at " TRACE_ALLOC_LOC_FMT ")\n",
-          ptr, ctx->allocations[i].info.size,
-          ctx->allocations[i].location.fn, ctx->allocations[i].location.line,
-          fn, line
-        );
-
-        break;
-      }
-    }
+  /* Record is dropped before free, so pointer isn't used after it */
+  if (ctx->enabled && ptr) {
+    trace_free_track(ctx, ptr, fn, line);
   }
+
+  TRACE_ALLOC_PORT_FREE_FN(ptr);
 }
 
 #if TRACE_ALLOC_USE_SINGLE_INSTANCE
@@ -126,5 +332,3 @@ trace_alloc_ctx_t * trace_alloc_get_instance(void) {
   return &trace_alloc_instance;
 }
 #endif
-
-
@@ -6,6 +6,16 @@
  *
  * @brief Allocator trace. Can trace calls to alloc/free and detect leaks
  *
+ * Live allocations are kept in an open-addressed hash index (pointer ->
+ * record), so alloc & free are O(1) on average. Every record points to a
+ * call site (trace_alloc() location), that aggregates allocation count,
+ * live bytes and peak bytes. On trace_alloc_end leaks are reported per call
+ * site, sorted by leaked bytes.
+ *
+ * Instead of (slow) log lines, every event can be passed to a callback as
+ * a compact binary record (see TRACE_ALLOC_USE_EVENTS), to be dumped and
+ * decoded offline.
+ *
  * TODO: Maybe use gcc wrappers for target alloc/free?
  *
  *  ========================================================================= */
@@ -18,6 +28,8 @@ extern "C" {
 /* Includes ================================================================= */
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdint.h>
+#include "util/compiler.h"
 
 /**
  * Include header needed by TRACE_ALLOC_PORT_ALLOC_FN/TRACE_ALLOC_PORT_FREE_FN
@@ -36,10 +48,33 @@ extern "C" {
 
 /* Defines ================================================================== */
 /**
- * Max allocations that can be traced
+ * Max live allocations that can be traced, must be power of 2
+ * Index is kept under 75% load, so usable capacity is 3/4 of that
  */
 #ifndef TRACE_ALLOC_BUF_SIZE
-#define TRACE_ALLOC_BUF_SIZE              32
+#define TRACE_ALLOC_BUF_SIZE              64
+#endif
+
+/**
+ * Max distinct call sites, must be power of 2
+ */
+#ifndef TRACE_ALLOC_SITE_COUNT
+#define TRACE_ALLOC_SITE_COUNT            16
+#endif
+
+/**
+ * If enabled, every alloc/free is printed with TRACE_ALLOC_PORT_LOG
+ */
+#ifndef TRACE_ALLOC_USE_LOG
+#define TRACE_ALLOC_USE_LOG               0
+#endif
+
+/**
+ * If enabled, every alloc/free is passed to event callback as
+ * trace_alloc_event_t (see trace_alloc_set_event_cb)
+ */
+#ifndef TRACE_ALLOC_USE_EVENTS
+#define TRACE_ALLOC_USE_EVENTS            0
 #endif
 
 /**
@@ -71,6 +106,11 @@ extern "C" {
 #define TRACE_ALLOC_PORT_LOG              log_printf
 #endif
 
+/**
+ * Site index of allocations, that didn't fit into site table
+ */
+#define TRACE_ALLOC_SITE_NONE             0xFFFF
+
 /* Macros =================================================================== */
 /**
  * Calls TRACE_ALLOC_PORT_ALLOC_FN and saves allocation context
@@ -91,40 +131,83 @@ extern "C" {
   trace_free_impl(ptr, __FUNCTION__, __LINE__)
 
 /* Enums ==================================================================== */
+/**
+ * Binary event type
+ */
+typedef enum {
+  TRACE_ALLOC_EVENT_ALLOC = 0,    /** Allocation, size is requested size */
+  TRACE_ALLOC_EVENT_FREE,         /** Free of traced allocation */
+  TRACE_ALLOC_EVENT_FREE_UNKNOWN, /** Free of pointer, that isn't traced */
+  TRACE_ALLOC_EVENT_ALLOC_FAIL,   /** Allocation failed, ptr is 0 */
+  TRACE_ALLOC_EVENT_DROP,         /** Allocation not traced, index is full */
+} trace_alloc_event_type_t;
+
 /* Types ==================================================================== */
 /**
- * Single allocation context
+ * Traced allocation (index record)
  */
 typedef struct {
-  /**
-   * Allocation info
-   */
-  struct {
-    void * ptr;
-    size_t size;
-  } info;
+  void * ptr;       /** Allocated pointer, NULL if record is empty */
+  uint32_t size;    /** Requested size */
+  uint16_t site;    /** Call site index */
+} trace_alloc_t;
 
+/**
+ * Call site, aggregates all allocations made from single trace_alloc()
+ */
+typedef struct {
   /**
-   * trace_alloc() call location
+   * trace_alloc() call location, fn is NULL if site is unused
    */
   struct {
     const char * fn;
     size_t       line;
   } location;
 
-  /**
-   * Needed for trace_alloc_ctx_t
-   */
-  bool allocated;
-} trace_alloc_t;
+  size_t allocs;      /** Total allocations */
+  size_t count;       /** Live allocations */
+  size_t bytes;       /** Live bytes */
+  size_t peak;        /** Peak of live bytes */
+} trace_alloc_site_t;
+
+/**
+ * Binary event, all fields are little-endian on supported targets
+ */
+typedef __PACKED_STRUCT {
+  uint8_t  type;      /** trace_alloc_event_type_t */
+  uint8_t  reserved;
+  uint16_t site;      /** Call site index, TRACE_ALLOC_SITE_NONE if unknown */
+  uint32_t seq;       /** Event sequence number */
+  uint32_t ptr;       /** Pointer (lower 32 bits) */
+  uint32_t size;      /** Allocation size */
+} trace_alloc_event_t;
+
+/**
+ * Event callback
+ *
+ * @param user User context
+ * @param event Event, valid only during the call
+ */
+typedef void (*trace_alloc_event_cb_t)(void * user, const trace_alloc_event_t * event);
 
 /**
  * Context for trace_alloc/trace_free to save allocation traces to
  */
 typedef struct {
-  trace_alloc_t allocations[TRACE_ALLOC_BUF_SIZE];
+  trace_alloc_t allocations[TRACE_ALLOC_BUF_SIZE];  /** Pointer index */
+  trace_alloc_site_t sites[TRACE_ALLOC_SITE_COUNT]; /** Call sites */
+
+  size_t count;       /** Live traced allocations */
+  size_t dropped;     /** Allocations not traced, because index was full */
+  size_t unknown;     /** Frees of untraced pointers */
+  uint32_t seq;       /** Next event sequence number */
+
+#if TRACE_ALLOC_USE_EVENTS
+  trace_alloc_event_cb_t event_cb;
+  void * event_user;
+#endif
+
   bool enabled;
-  bool trace_only;
 } trace_alloc_ctx_t;
 
 /* Variables ================================================================ */
@@ -132,13 +215,15 @@ typedef struct {
 /**
  * Starts trace
  *
+ * @note Clears event callback
+ *
  * @param ctx Trace context. If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled and
  *            ctx is NULL, will use global instance
  */
 void trace_alloc_start(trace_alloc_ctx_t * ctx);
 
 /**
- * Stops trace
+ * Stops trace and prints leak report
  *
  * @param ctx Trace context. If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled and
  *            ctx is NULL, will use global instance
@@ -146,6 +231,27 @@ void trace_alloc_start(trace_alloc_ctx_t * ctx);
  */
 size_t trace_alloc_end(trace_alloc_ctx_t * ctx);
 
+/**
+ * Prints call sites with live allocations, sorted by live bytes
+ *
+ * @param ctx Trace context. If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled and
+ *            ctx is NULL, will use global instance
+ * @return Number of live allocations
+ */
+size_t trace_alloc_report(trace_alloc_ctx_t * ctx);
+
+#if TRACE_ALLOC_USE_EVENTS
+/**
+ * Sets event callback, call after trace_alloc_start
+ *
+ * @param ctx Trace context. If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled and
+ *            ctx is NULL, will use global instance
+ * @param cb Callback, NULL to disable events
+ * @param user User context passed to cb
+ */
+void trace_alloc_set_event_cb(trace_alloc_ctx_t * ctx, trace_alloc_event_cb_t cb, void * user);
+#endif
+
 /**
  * Implementation for trace_alloc, not meant to be called directly
  *
@@ -168,7 +274,7 @@ void trace_free_impl(void * ptr, const char * fn, size_t line);
 /**
  * Returns current instance of trace_alloc_ctx_t
  *
- * @bite If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled will be implemented and
+ * @note If TRACE_ALLOC_USE_SINGLE_INSTANCE is enabled will be implemented and
  *       will return global instance, if disabled, user must implement this
  *
  * @return trace_alloc context
@@ -177,4 +283,4 @@ trace_alloc_ctx_t * trace_alloc_get_instance(void);
 
 #ifdef __cplusplus
 }
-#endif
\ No newline at end of file
+#endif
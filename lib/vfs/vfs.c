@@ -26,6 +26,12 @@
 #endif
 
 /* Macros ============================================`======================= */
+/** Count request submitted on descriptor (completion may come from IRQ) */
+#define VFS_PENDING_INC(__fd)   VFS_ATOMIC_BLOCK() { (__fd)->pending++; }
+
+/** Count request cancelled on descriptor */
+#define VFS_PENDING_DEC(__fd)   VFS_ATOMIC_BLOCK() { (__fd)->pending--; }
+
 /* Exposed macros =========================================================== */
 /* Enums ==================================================================== */
 /* Types ==================================================================== */
@@ -37,98 +43,70 @@
 vfs_t vfs;
 #endif
 
+#if VFS_DCACHE_SIZE
+_Static_assert(VFS_DCACHE_SIZE >= 2, "VFS_DCACHE_SIZE must be 0 or at least 2");
+#endif
+
 /* Private functions ======================================================== */
 /**
- * Resets Node Pool
+ * Matches folder child by name, used as table key callback
  */
-__STATIC_INLINE error_t vfs_node_pool_reset(vfs_node_pool_t * pool) {
-  ASSERT_RETURN(pool, E_NULL);
-
-  memset(pool->nodes, 0, sizeof(vfs_node_container_t) * pool->size);
+static bool vfs_table_key_match(const void * value, const void * key) {
+  const char * name = vfs_get_node_name((vfs_node_t *) value);
 
-  return E_OK;
+  return name && !strcmp(name, key);
 }
 
 /**
- * Node Allocate
+ * Table Allocate from pool
  *
- * Pointer to allocated node will be placed in *node
+ * Pointer to allocated table will be placed in *table
  */
-__STATIC_INLINE error_t vfs_node_pool_alloc(vfs_node_pool_t * pool, vfs_node_t ** node) {
-  ASSERT_RETURN(pool && node, E_NULL);
-
-  for (size_t i = 0; i < pool->size; ++i) {
-    if (!pool->nodes[i].used) {
-      pool->nodes[i].used = true;
-      *node = &pool->nodes[i].node;
-      return E_OK;
-    }
-  }
-
-  return E_NOMEM;
-}
+__STATIC_INLINE error_t vfs_table_pool_alloc(vfs_table_pool_t * pool, table_t ** table) {
+  ASSERT_RETURN(pool && table, E_NULL);
 
-/**
- * Node Free
- */
-__STATIC_INLINE error_t vfs_node_pool_free(vfs_node_pool_t * pool, vfs_node_t * node) {
-  ASSERT_RETURN(pool, E_NULL);
+  vfs_table_container_t * container = os_pool_alloc(pool);
 
-  for (size_t i = 0; i < pool->size; ++i) {
-    if (&pool->nodes[i].node == node) {
-      pool->nodes[i].used = false;
-      return E_OK;
-    }
+  if (!container) {
+    return E_NOMEM;
   }
 
-  return E_NOTFOUND;
-}
-
-/**
- * Resets Table Pool
- */
-__STATIC_INLINE error_t vfs_table_pool_reset(vfs_table_pool_t * pool) {
-  ASSERT_RETURN(pool, E_NULL);
-
-  memset(pool->tables, 0, sizeof(vfs_table_container_t) * pool->size);
+  ERROR_CHECK_RETURN(table_init(&container->table, container->nodes, VFS_MAX_FOLDER_CHILDREN));
+  ERROR_CHECK_RETURN(table_set_key_match(&container->table, vfs_table_key_match));
+  *table = &container->table;
 
   return E_OK;
 }
 
 /**
- * Table Allocate
- *
- * Pointer to allocated table will be placed in *table
+ * Counts successful or failed dynamic allocation
  */
-__STATIC_INLINE error_t vfs_table_pool_alloc(vfs_table_pool_t * pool, table_t ** table) {
-  ASSERT_RETURN(pool && table, E_NULL);
-
-  for (size_t i = 0; i < pool->size; ++i) {
-    if (!pool->tables[i].used) {
-      pool->tables[i].used = true;
-      ERROR_CHECK_RETURN(table_init(&pool->tables[i].table, pool->tables[i].nodes, VFS_MAX_FOLDER_CHILDREN));
-      *table = &pool->tables[i].table;
-      return E_OK;
-    }
+__STATIC_INLINE void vfs_stats_alloc(vfs_pool_stats_t * stats, error_t err) {
+  if (err != E_OK) {
+    stats->exhausted++;
+    return;
   }
 
-  return E_NOMEM;
+  stats->used++;
+  stats->high_water = UTIL_MAX(stats->high_water, stats->used);
 }
 
 /**
- * Table Free
+ * Counts dynamic free
  */
-__STATIC_INLINE error_t vfs_table_pool_free(vfs_table_pool_t * pool, table_t * table) {
-  ASSERT_RETURN(pool, E_NULL);
-
-  for (size_t i = 0; i < pool->size; ++i) {
-    if (&pool->tables[i].table == table) {
-      pool->tables[i].used = false;
-      return E_OK;
-    }
+__STATIC_INLINE void vfs_stats_free(vfs_pool_stats_t * stats) {
+  if (stats->used) {
+    stats->used--;
   }
+}
 
-  return E_NOTFOUND;
+/**
+ * Fills allocation statistics from os_pool ones
+ */
+__STATIC_INLINE void vfs_stats_from_pool(vfs_pool_stats_t * stats, os_pool_t * pool) {
+  stats->used = pool->used;
+  stats->high_water = pool->peak;
+  stats->exhausted = pool->fails;
 }
 
 /**
@@ -139,12 +117,19 @@ __STATIC_INLINE error_t vfs_node_alloc(vfs_t * vfs, vfs_node_t ** node) {
   ASSERT_RETURN(vfs, E_NULL);
 
   if (vfs->node_pool) {
-    return vfs_node_pool_alloc(vfs->node_pool, node);
+    *node = os_pool_alloc(vfs->node_pool);
   } else {
     *node = VFS_ALLOC(sizeof(vfs_node_t));
-    ASSERT_RETURN(*node, E_NOMEM);
+    vfs_stats_alloc(&vfs->stats.nodes, *node ? E_OK : E_NOMEM);
   }
 
+  if (!*node) {
+    return E_NOMEM;
+  }
+
+  // Pool keeps free list link in node memory, so don't hand out stale bytes
+  memset(*node, 0, sizeof(vfs_node_t));
+
   return E_OK;
 }
 
@@ -155,11 +140,12 @@ __STATIC_INLINE error_t vfs_node_free(vfs_t * vfs, vfs_node_t * node) {
   ASSERT_RETURN(vfs, E_NULL);
 
   if (vfs->node_pool) {
-    return vfs_node_pool_free(vfs->node_pool, node);
-  } else {
-    VFS_FREE(node);
+    return os_pool_free(vfs->node_pool, node);
   }
 
+  VFS_FREE(node);
+  vfs_stats_free(&vfs->stats.nodes);
+
   return E_OK;
 }
 
@@ -172,17 +158,28 @@ __STATIC_INLINE error_t vfs_table_alloc(vfs_t * vfs, table_t ** table) {
 
   if (vfs->table_pool) {
     return vfs_table_pool_alloc(vfs->table_pool, table);
-  } else {
-    *table = VFS_ALLOC(sizeof(table_t));
-    ASSERT_RETURN(*table, E_NOMEM);
+  }
+
+  error_t err = E_OK;
 
-    table_node_t * children = VFS_ALLOC(sizeof(table_node_t) * VFS_MAX_FOLDER_CHILDREN);
-    ASSERT_RETURN(children, E_NOMEM);
+  *table = VFS_ALLOC(sizeof(table_t));
+  table_node_t * children = *table ? VFS_ALLOC(sizeof(table_node_t) * VFS_MAX_FOLDER_CHILDREN) : NULL;
 
-    ERROR_CHECK_RETURN(table_init(*table, children, VFS_MAX_FOLDER_CHILDREN));
+  if (children) {
+    table_init(*table, children, VFS_MAX_FOLDER_CHILDREN);
+    table_set_key_match(*table, vfs_table_key_match);
+  } else {
+    if (*table) {
+      VFS_FREE(*table);
+      *table = NULL;
+    }
+
+    err = E_NOMEM;
   }
 
-  return E_OK;
+  vfs_stats_alloc(&vfs->stats.tables, err);
+
+  return err;
 }
 
 /**
@@ -191,16 +188,41 @@ __STATIC_INLINE error_t vfs_table_alloc(vfs_t * vfs, table_t ** table) {
 __STATIC_INLINE error_t vfs_table_free(vfs_t * vfs, table_t * table) {
   ASSERT_RETURN(vfs, E_NULL);
 
+  // Table is the first member of container
   if (vfs->table_pool) {
-    return vfs_table_pool_free(vfs->table_pool, table);
-  } else {
-    VFS_FREE(table->nodes);
-    VFS_FREE(table);
+    return os_pool_free(vfs->table_pool, table);
   }
 
+  VFS_FREE(table->nodes);
+  VFS_FREE(table);
+  vfs_stats_free(&vfs->stats.tables);
+
   return E_OK;
 }
 
+/**
+ * Adds child to folder table
+ *
+ * Dynamically allocated tables are grown twice, when getting too full,
+ * tables from pool have fixed capacity
+ */
+__STATIC_INLINE error_t vfs_table_add(vfs_t * vfs, table_t * table, const char * name, vfs_node_t * node) {
+  ASSERT_RETURN(vfs && table, E_NULL);
+
+  if (!vfs->table_pool && table_should_grow(table)) {
+    size_t capacity = table_get_capacity(table) * 2;
+    table_node_t * old = table->nodes;
+    table_node_t * nodes = VFS_ALLOC(sizeof(table_node_t) * capacity);
+
+    if (nodes) {
+      table_resize(table, nodes, capacity);
+      VFS_FREE(old);
+    }
+  }
+
+  return table_add_str(table, name, node);
+}
+
 /**
  * Generic node name setter
  */
@@ -236,13 +258,9 @@ __STATIC_INLINE error_t vfs_set_node_name(vfs_node_t * node, const char * name)
 }
 
 /**
- * Finds node by given path
- *
- * Cornerstone of half of APIs in VFS
+ * Finds node by given path, walking the tree from root
  */
-__STATIC_INLINE vfs_node_t * vfs_find_node(vfs_t * vfs, const char * path) {
-  ASSERT_RETURN(vfs && path, NULL);
-
+__STATIC_INLINE vfs_node_t * vfs_walk_path(vfs_t * vfs, const char * path) {
   // Split path into tokens
   vfs_path_split_ctx_t split;
   ASSERT_RETURN(vfs_path_split(path, &split) == E_OK, NULL);
@@ -274,6 +292,111 @@ __STATIC_INLINE vfs_node_t * vfs_find_node(vfs_t * vfs, const char * path) {
   return tmp;
 }
 
+#if VFS_DCACHE_SIZE
+/**
+ * Advances LRU clock of path lookup cache
+ *
+ * On overflow all stamps are collapsed to 1, which only loses LRU order
+ */
+__STATIC_INLINE uint32_t vfs_dcache_tick(vfs_t * vfs) {
+  if (++vfs->dcache.tick == UINT32_MAX) {
+    for (size_t i = 0; i < VFS_DCACHE_SIZE; ++i) {
+      if (vfs->dcache.entries[i].used) {
+        vfs->dcache.entries[i].used = 1;
+      }
+    }
+
+    vfs->dcache.tick = 2;
+  }
+
+  return vfs->dcache.tick;
+}
+
+/**
+ * Looks path up in path lookup cache, counts hit/miss
+ */
+__STATIC_INLINE vfs_dcache_entry_t * vfs_dcache_find(vfs_t * vfs, const char * path, table_hash_t hash) {
+  for (size_t i = 0; i < VFS_DCACHE_SIZE; ++i) {
+    vfs_dcache_entry_t * entry = &vfs->dcache.entries[i];
+
+    if (entry->used && entry->hash == hash && !strcmp(entry->path, path)) {
+      entry->used = vfs_dcache_tick(vfs);
+      vfs->dcache.stats.hits++;
+      return entry;
+    }
+  }
+
+  vfs->dcache.stats.misses++;
+
+  return NULL;
+}
+
+/**
+ * Puts path into path lookup cache, evicting least recently used entry
+ *
+ * @retval NULL if path is too long to be cached
+ */
+__STATIC_INLINE vfs_dcache_entry_t * vfs_dcache_insert(vfs_t * vfs, const char * path, table_hash_t hash, vfs_node_t * node) {
+  if (strlen(path) >= VFS_MAX_PATH) {
+    return NULL;
+  }
+
+  vfs_dcache_entry_t * entry = &vfs->dcache.entries[0];
+
+  for (size_t i = 1; i < VFS_DCACHE_SIZE && entry->used; ++i) {
+    if (vfs->dcache.entries[i].used < entry->used) {
+      entry = &vfs->dcache.entries[i];
+    }
+  }
+
+  entry->used = vfs_dcache_tick(vfs);
+  entry->hash = hash;
+  entry->node = node;
+  entry->target = NULL;
+  strcpy(entry->path, path);
+
+  return entry;
+}
+
+/**
+ * Finds cache entry for path, walking the tree on miss
+ *
+ * @param node Node found by path (NULL if there is no such node). Result
+ * @retval NULL if there is no such node, or path can't be cached
+ */
+__STATIC_INLINE vfs_dcache_entry_t * vfs_dcache_lookup(vfs_t * vfs, const char * path, vfs_node_t ** node) {
+  table_hash_t hash = table_str_hash(path);
+  vfs_dcache_entry_t * entry = vfs_dcache_find(vfs, path, hash);
+
+  if (entry) {
+    *node = entry->node;
+    return entry;
+  }
+
+  *node = vfs_walk_path(vfs, path);
+
+  return *node ? vfs_dcache_insert(vfs, path, hash, *node) : NULL;
+}
+#endif
+
+/**
+ * Finds node by given path
+ *
+ * Cornerstone of half of APIs in VFS
+ */
+__STATIC_INLINE vfs_node_t * vfs_find_node(vfs_t * vfs, const char * path) {
+  ASSERT_RETURN(vfs && path, NULL);
+
+#if VFS_DCACHE_SIZE
+  vfs_node_t * node = NULL;
+  vfs_dcache_lookup(vfs, path, &node);
+
+  return node;
+#else
+  return vfs_walk_path(vfs, path);
+#endif
+}
+
 /**
  * Given a path, retrieves parent node and file name
  *
@@ -321,6 +444,72 @@ __STATIC_INLINE vfs_node_t * vfs_resolve_link(vfs_t * vfs, vfs_node_t * node) {
   }
 }
 
+/**
+ * Finds node by given path and resolves it, if it's a link
+ */
+__STATIC_INLINE vfs_node_t * vfs_find_resolved(vfs_t * vfs, const char * path) {
+  ASSERT_RETURN(vfs && path, NULL);
+
+  vfs_node_t * node = NULL;
+
+#if VFS_DCACHE_SIZE
+  vfs_dcache_entry_t * entry = vfs_dcache_lookup(vfs, path, &node);
+
+  if (entry) {
+    // Resolving a symlink may insert its target, which never evicts
+    // the entry that was just used
+    if (!entry->target) {
+      entry->target = vfs_resolve_link(vfs, entry->node);
+    }
+
+    return entry->target;
+  }
+#else
+  node = vfs_find_node(vfs, path);
+#endif
+
+  return node ? vfs_resolve_link(vfs, node) : NULL;
+}
+
+/**
+ * Takes free descriptor from VFS descriptor pool
+ */
+__STATIC_INLINE vfs_fd_t * vfs_fd_alloc(vfs_t * vfs) {
+  for (size_t i = 0; i < VFS_MAX_OPEN_FILES; ++i) {
+    vfs_fd_t * fd = &vfs->fds[i];
+
+    if (!(fd->flags & VFS_FD_FLAG_USED)) {
+      fd->vfs = vfs;
+      fd->offset = 0;
+      fd->flags = VFS_FD_FLAG_USED;
+      fd->pending = 0;
+      return fd;
+    }
+  }
+
+  return NULL;
+}
+
+/**
+ * Returns descriptor to VFS descriptor pool
+ */
+__STATIC_INLINE void vfs_fd_free(vfs_fd_t * fd) {
+  fd->flags = VFS_FD_FLAG_NONE;
+}
+
+/**
+ * Checks whether any descriptor still references the node
+ */
+__STATIC_INLINE bool vfs_node_is_opened(vfs_t * vfs, vfs_node_t * node) {
+  for (size_t i = 0; i < VFS_MAX_OPEN_FILES; ++i) {
+    if (vfs->fds[i].flags & VFS_FD_FLAG_USED && vfs->fds[i].node == node) {
+      return true;
+    }
+  }
+
+  return false;
+}
+
 /**
  * Generic Node Initialization (without node-specific data)
  */
@@ -328,10 +517,7 @@ __STATIC_INLINE error_t vfs_node_init(vfs_node_t * node, vfs_node_type_t type, c
   ASSERT_RETURN(node && name, E_NULL);
 
   node->head.type = type;
-
-  if (allocated) {
-    node->head.flags |= VFS_NODE_FLAG_ALLOCATED;
-  }
+  node->head.flags = allocated ? VFS_NODE_FLAG_ALLOCATED : VFS_NODE_FLAG_NONE;
 
   vfs_set_node_name(node, name);
 
@@ -347,10 +533,10 @@ __STATIC_INLINE error_t vfs_node_deinit(vfs_t * vfs, vfs_node_t * node) {
   ASSERT_RETURN(node, E_NULL);
 
   if (node->head.type == VFS_FOLDER) {
-    for (size_t i = 0; i < node->folder.children->capacity; ++i) {
-      if (node->folder.children->nodes[i].used) {
-        ERROR_CHECK_RETURN(vfs_node_deinit(vfs, node->folder.children->nodes[i].value));
-      }
+    vfs_node_t * child = NULL;
+
+    TABLE_FOREACH(node->folder.children, iter, child) {
+      ERROR_CHECK_RETURN(vfs_node_deinit(vfs, child));
     }
 
     if (node->folder.flags.allocated) {
@@ -427,7 +613,7 @@ __STATIC_INLINE error_t vfs_create_symlink_common(vfs_t * vfs, const char * path
 /**
  * Common part of vfs_create_hardlink*
  */
-__STATIC_INLINE error_t vfs_create_hardlink_common(vfs_t * vfs, const char * path, vfs_file_t * link_node) {
+__STATIC_INLINE error_t vfs_create_hardlink_common(vfs_t * vfs, const char * path, vfs_node_t * link_node) {
   vfs_node_t * node = vfs_find_node(vfs, path);
 
   ASSERT_RETURN(node, E_FAILED);
@@ -437,6 +623,49 @@ __STATIC_INLINE error_t vfs_create_hardlink_common(vfs_t * vfs, const char * pat
   return E_OK;
 }
 
+/**
+ * Common part of vfs_read_async/vfs_write_async
+ *
+ * Request is marked pending before it's handed to the driver, as driver
+ * may complete it before submit returns. Without submit callback, plain
+ * read/write is done and request is completed right away
+ */
+__STATIC_INLINE error_t vfs_request_submit(vfs_file_t * file, vfs_request_t * request, vfs_request_type_t type) {
+  ASSERT_RETURN(file && request && request->buffer && request->size, E_NULL);
+  ASSERT_RETURN(request->state != VFS_REQUEST_STATE_PENDING, E_BUSY);
+  ASSERT_RETURN(file->pending < UINT8_MAX, E_BUSY);
+
+  vfs_node_t * node = file->node;
+
+  request->file = file;
+  request->next = NULL;
+  request->status = E_OK;
+  request->type = type;
+  request->state = VFS_REQUEST_STATE_PENDING;
+#if USE_VFS_OS
+  request->waiter = NULL;
+#endif
+
+  VFS_PENDING_INC(file);
+
+  if (node->head.type == VFS_BLOCK && node->block.data.submit) {
+    error_t err = node->block.data.submit(node->block.data.ctx, request);
+
+    if (err != E_OK) {
+      VFS_PENDING_DEC(file);
+      request->state = VFS_REQUEST_STATE_IDLE;
+    }
+
+    return err;
+  }
+
+  error_t status = type == VFS_REQUEST_READ
+    ? vfs_read(file, request->buffer, request->size, VFS_READ_FLAG_NONE)
+    : vfs_write(file, request->buffer, request->size);
+
+  return vfs_request_complete(request, status);
+}
+
 /* Shared functions ========================================================= */
 error_t vfs_path_concat(char * dest, const char * src, size_t max_size) {
   ASSERT_RETURN(dest && src, E_NULL);
@@ -627,8 +856,8 @@ error_t vfs_path_name(char * path) {
 size_t vfs_get_file_size(vfs_file_t * file) {
   ASSERT_RETURN(file, 0);
 
-  if (file->head.type == VFS_FILE) {
-    return file->file.data.size;
+  if (file->node->head.type == VFS_FILE) {
+    return file->node->file.data.size;
   }
 
   return 0;
@@ -638,9 +867,9 @@ error_t vfs_set_multi_open_flag(vfs_file_t * file, bool flag) {
   ASSERT_RETURN(file, E_NULL);
 
   if (flag) {
-    file->head.flags |= VFS_NODE_FLAG_MULTI_OPEN;
+    file->node->head.flags |= VFS_NODE_FLAG_MULTI_OPEN;
   } else {
-    file->head.flags &= !VFS_NODE_FLAG_MULTI_OPEN;
+    file->node->head.flags &= ~VFS_NODE_FLAG_MULTI_OPEN;
   }
 
   return E_OK;
@@ -649,17 +878,29 @@ error_t vfs_set_multi_open_flag(vfs_file_t * file, bool flag) {
 const char * vfs_get_file_name(vfs_file_t * file) {
   ASSERT_RETURN(file, NULL);
 
-  switch (file->head.type) {
-    case VFS_FOLDER:    return file->folder.name;
-    case VFS_FILE:      return file->file.name;
-    case VFS_BLOCK:     return file->block.name;
-    case VFS_SYMLINK:   return file->symlink.name;
-    case VFS_HARDLINK:  return file->hardlink.name;
+  return vfs_get_node_name(file->node);
+}
+
+const char * vfs_get_node_name(vfs_node_t * node) {
+  ASSERT_RETURN(node, NULL);
+
+  switch (node->head.type) {
+    case VFS_FOLDER:    return node->folder.name;
+    case VFS_FILE:      return node->file.name;
+    case VFS_BLOCK:     return node->block.name;
+    case VFS_SYMLINK:   return node->symlink.name;
+    case VFS_HARDLINK:  return node->hardlink.name;
     default:
       return NULL;
   }
 }
 
+vfs_node_t * vfs_get_file_node(vfs_file_t * file) {
+  ASSERT_RETURN(file, NULL);
+
+  return file->node;
+}
+
 const char * vfs_node_type_to_string(vfs_node_type_t type) {
   switch (type) {
     case VFS_FOLDER:    return "FOLDER";
@@ -681,11 +922,13 @@ error_t vfs_init(vfs_t * vfs, vfs_node_pool_t * node_pool, vfs_table_pool_t * ta
   vfs->table_pool = table_pool;
 
   if (node_pool) {
-    vfs_node_pool_reset(vfs->node_pool);
+    ASSERT_RETURN(node_pool->elem_size >= sizeof(vfs_node_t), E_INVAL);
+    ERROR_CHECK_RETURN(os_pool_reset(node_pool));
   }
 
   if (table_pool) {
-    vfs_table_pool_reset(vfs->table_pool);
+    ASSERT_RETURN(table_pool->elem_size >= sizeof(vfs_table_container_t), E_INVAL);
+    ERROR_CHECK_RETURN(os_pool_reset(table_pool));
   }
 
   ERROR_CHECK_RETURN(vfs_node_init(&vfs->root, VFS_FOLDER, "/", false));
@@ -703,9 +946,48 @@ error_t vfs_deinit(vfs_t * vfs) {
   ERROR_CHECK_RETURN(vfs_node_deinit(vfs, &vfs->root));
   ERROR_CHECK_RETURN(vfs_table_free(vfs, vfs->root.folder.children));
 
+  return vfs_dcache_flush(vfs);
+}
+
+error_t vfs_get_stats(vfs_t * vfs, vfs_stats_t * stats) {
+  ASSERT_RETURN(vfs && stats, E_NULL);
+
+  *stats = vfs->stats;
+
+  if (vfs->node_pool) {
+    vfs_stats_from_pool(&stats->nodes, vfs->node_pool);
+  }
+
+  if (vfs->table_pool) {
+    vfs_stats_from_pool(&stats->tables, vfs->table_pool);
+  }
+
+  return E_OK;
+}
+
+error_t vfs_dcache_flush(vfs_t * vfs) {
+  ASSERT_RETURN(vfs, E_NULL);
+
+#if VFS_DCACHE_SIZE
+  memset(vfs->dcache.entries, 0, sizeof(vfs->dcache.entries));
+  vfs->dcache.tick = 0;
+#endif
+
   return E_OK;
 }
 
+error_t vfs_dcache_get_stats(vfs_t * vfs, vfs_dcache_stats_t * stats) {
+  ASSERT_RETURN(vfs && stats, E_NULL);
+
+#if VFS_DCACHE_SIZE
+  *stats = vfs->dcache.stats;
+
+  return E_OK;
+#else
+  return E_NOTIMPL;
+#endif
+}
+
 error_t vfs_create(vfs_t * vfs, const char * path, vfs_file_type_t type) {
   ASSERT_RETURN(vfs && path, E_NULL);
 
@@ -718,9 +1000,15 @@ error_t vfs_create(vfs_t * vfs, const char * path, vfs_file_type_t type) {
 
   ERROR_CHECK_RETURN(vfs_node_alloc(vfs, &new_node));
   ERROR_CHECK_RETURN(vfs_node_init(new_node, type, name, true));
-  ERROR_CHECK_RETURN(table_add_str(parent->folder.children, name, new_node));
 
-  return E_OK;
+  error_t err = vfs_table_add(vfs, parent->folder.children, name, new_node);
+
+  if (err != E_OK) {
+    vfs_node_free(vfs, new_node);
+    return err;
+  }
+
+  return vfs_dcache_flush(vfs);
 }
 
 error_t vfs_create_static(vfs_t * vfs, const char * path, vfs_file_type_t type, vfs_node_t * file) {
@@ -732,9 +1020,9 @@ error_t vfs_create_static(vfs_t * vfs, const char * path, vfs_file_type_t type,
   ERROR_CHECK_RETURN(vfs_find_parent_and_name(vfs, path, &parent, name));
 
   ERROR_CHECK_RETURN(vfs_node_init(file, type, name, false));
-  ERROR_CHECK_RETURN(table_add_str(parent->folder.children, name, file));
+  ERROR_CHECK_RETURN(vfs_table_add(vfs, parent->folder.children, name, file));
 
-  return E_OK;
+  return vfs_dcache_flush(vfs);
 }
 
 error_t vfs_create_folder(vfs_t * vfs, const char * path) {
@@ -776,7 +1064,7 @@ error_t vfs_create_block(vfs_t * vfs, const char * path, const vfs_block_data_t
   return vfs_create_block_common(vfs, path, data);
 }
 
-error_t vfs_create_block_static(vfs_t * vfs, const char * path, const vfs_block_data_t * data, vfs_file_t * file) {
+error_t vfs_create_block_static(vfs_t * vfs, const char * path, const vfs_block_data_t * data, vfs_node_t * file) {
   ERROR_CHECK_RETURN(vfs_create_static(vfs, path, VFS_BLOCK, file));
 
   return vfs_create_block_common(vfs, path, data);
@@ -788,19 +1076,19 @@ error_t vfs_create_symlink(vfs_t * vfs, const char * path, const char * link) {
   return vfs_create_symlink_common(vfs, path, link);
 }
 
-error_t vfs_create_symlink_static(vfs_t * vfs, const char * path, const char * link, vfs_file_t * file) {
+error_t vfs_create_symlink_static(vfs_t * vfs, const char * path, const char * link, vfs_node_t * file) {
   ERROR_CHECK_RETURN(vfs_create_static(vfs, path, VFS_SYMLINK, file));
 
   return vfs_create_symlink_common(vfs, path, link);
 }
 
-error_t vfs_create_hardlink(vfs_t * vfs, const char * path, vfs_file_t * link_node) {
+error_t vfs_create_hardlink(vfs_t * vfs, const char * path, vfs_node_t * link_node) {
   ERROR_CHECK_RETURN(vfs_create(vfs, path, VFS_SYMLINK));
 
   return vfs_create_hardlink_common(vfs, path, link_node);
 }
 
-error_t vfs_create_hardlink_static(vfs_t * vfs, const char * path, vfs_file_t * link_node, vfs_file_t * file) {
+error_t vfs_create_hardlink_static(vfs_t * vfs, const char * path, vfs_node_t * link_node, vfs_node_t * file) {
   ERROR_CHECK_RETURN(vfs_create_static(vfs, path, VFS_SYMLINK, file));
 
   return vfs_create_hardlink_common(vfs, path, link_node);
@@ -815,9 +1103,13 @@ error_t vfs_remove(vfs_t * vfs, const char * path) {
   ERROR_CHECK_RETURN(vfs_find_parent_and_name(vfs, path, &parent, name));
 
   vfs_node_t * node_to_remove = vfs_find_node(vfs, path);
-  ERROR_CHECK_RETURN(vfs_node_deinit(vfs, node_to_remove));
+  ASSERT_RETURN(node_to_remove, E_NOTFOUND);
+  ASSERT_RETURN(!vfs_node_is_opened(vfs, node_to_remove), E_BUSY);
 
+  // Unlink first, table matches key by node name
   ERROR_CHECK_RETURN(table_remove_str(parent->folder.children, name));
+  ERROR_CHECK_RETURN(vfs_dcache_flush(vfs));
+  ERROR_CHECK_RETURN(vfs_node_deinit(vfs, node_to_remove));
 
   return E_OK;
 }
@@ -831,10 +1123,18 @@ error_t vfs_rename(vfs_t * vfs, const char * path, const char * new_name) {
   ERROR_CHECK_RETURN(vfs_find_parent_and_name(vfs, path, &parent, name));
 
   vfs_node_t * node = vfs_find_node(vfs, path);
-  vfs_set_node_name(node, new_name);
+  ASSERT_RETURN(node, E_NOTFOUND);
+  ASSERT_RETURN(!vfs_node_is_opened(vfs, node), E_BUSY);
+
+  if (table_find_str(parent->folder.children, new_name)) {
+    return E_INUSE;
+  }
 
+  // Table matches key by node name, so it can't change while node is linked
   ERROR_CHECK_RETURN(table_remove_str(parent->folder.children, name));
-  ERROR_CHECK_RETURN(table_add_str(parent->folder.children, new_name, node));
+  ERROR_CHECK_RETURN(vfs_dcache_flush(vfs));
+  ERROR_CHECK_RETURN(vfs_set_node_name(node, new_name));
+  ERROR_CHECK_RETURN(vfs_table_add(vfs, parent->folder.children, new_name, node));
 
   return E_OK;
 }
@@ -875,7 +1175,8 @@ error_t vfs_mkdir(vfs_t * vfs, const char * path) {
         node->folder.children = table;
         node->folder.flags.allocated = true;
 
-        ERROR_CHECK_RETURN(table_add_str(tmp->folder.children, split.tokens.buffer[i], node));
+        ERROR_CHECK_RETURN(vfs_table_add(vfs, tmp->folder.children, split.tokens.buffer[i], node));
+        ERROR_CHECK_RETURN(vfs_dcache_flush(vfs));
 
         tmp = node;
       } else {
@@ -890,52 +1191,55 @@ error_t vfs_mkdir(vfs_t * vfs, const char * path) {
 vfs_file_t * vfs_open(vfs_t * vfs, const char * path) {
   ASSERT_RETURN(vfs && path, NULL);
 
+  vfs_node_t * node = NULL;
+
   if (!strcmp(path, "/")) {
-    return &vfs->root;
+    node = &vfs->root;
+  } else {
+    node = vfs_find_resolved(vfs, path);
   }
 
-  vfs_node_t * node = vfs_resolve_link(vfs, vfs_find_node(vfs, path));
-
   ASSERT_RETURN(node, NULL);
 
   if (node->head.flags & VFS_NODE_FLAG_OPENED && !(node->head.flags & VFS_NODE_FLAG_MULTI_OPEN)) {
     return NULL;
   }
 
-  switch (node->head.type) {
-    case VFS_FILE:
-      node->file.data.offset = 0;
-      break;
+  vfs_fd_t * fd = vfs_fd_alloc(vfs);
 
-    case VFS_BLOCK:
-      if (node->block.data.open) {
-        ASSERT_RETURN(node->block.data.open(node->block.data.ctx, node) == E_OK, NULL);
-      }
-      break;
+  if (!fd) {
+    return NULL;
+  }
 
-    default:
-      break;
+  fd->node = node;
+
+  if (node->head.type == VFS_BLOCK && node->block.data.open) {
+    ASSERT_OR_ELSE(node->block.data.open(node->block.data.ctx, fd) == E_OK,
+      vfs_fd_free(fd);
+      return NULL);
   }
 
   node->head.flags |= VFS_NODE_FLAG_OPENED;
 
-  return node;
+  return fd;
 }
 
 error_t vfs_close(vfs_file_t * file) {
   ASSERT_RETURN(file, E_NULL);
+  ASSERT_RETURN(file->flags & VFS_FD_FLAG_USED, E_INVAL);
+  ASSERT_RETURN(!file->pending, E_BUSY);
 
-  if (file->head.type == VFS_BLOCK) {
-    if (file->block.data.close) {
-      ERROR_CHECK_RETURN(file->block.data.close(file->block.data.ctx, file));
-    }
-  } else if (file->head.type == VFS_FILE) {
-    file->file.data.offset = 0;
+  vfs_node_t * node = file->node;
+
+  if (node->head.type == VFS_BLOCK && node->block.data.close) {
+    ERROR_CHECK_RETURN(node->block.data.close(node->block.data.ctx, file));
   }
 
-  file->head.flags &= ~VFS_NODE_FLAG_OPENED;
+  vfs_fd_free(file);
 
-  // TODO: ???
+  if (!vfs_node_is_opened(file->vfs, node)) {
+    node->head.flags &= ~VFS_NODE_FLAG_OPENED;
+  }
 
   return E_OK;
 }
@@ -943,17 +1247,19 @@ error_t vfs_close(vfs_file_t * file) {
 error_t vfs_read(vfs_file_t * file, uint8_t * buffer, size_t size, vfs_read_flags_t flags) {
   ASSERT_RETURN(file && buffer && size, E_NULL);
 
-  switch (file->head.type) {
+  vfs_node_t * node = file->node;
+
+  switch (node->head.type) {
     case VFS_FILE: {
-      size_t read_size = UTIL_MIN(file->file.data.size - file->file.data.offset, size);
-      void * res = memcpy(buffer, file->file.data.buffer + file->file.data.offset, read_size);
-      file->file.data.offset += read_size;
+      size_t read_size = UTIL_MIN(node->file.data.size - file->offset, size);
+      void * res = memcpy(buffer, node->file.data.buffer + file->offset, read_size);
+      file->offset += read_size;
       return res == buffer ? E_OK : E_FAILED;
     }
 
     case VFS_BLOCK: {
-      if (file->block.data.read) {
-        return file->block.data.read(file->block.data.ctx, file, buffer, size, flags);
+      if (node->block.data.read) {
+        return node->block.data.read(node->block.data.ctx, file, buffer, size, flags);
       }
       break;
     }
@@ -968,18 +1274,21 @@ error_t vfs_read(vfs_file_t * file, uint8_t * buffer, size_t size, vfs_read_flag
 error_t vfs_write(vfs_file_t * file, const uint8_t * buffer, size_t size) {
   ASSERT_RETURN(file && buffer && size, E_NULL);
 
-  switch (file->head.type) {
+  vfs_node_t * node = file->node;
+
+  switch (node->head.type) {
     case VFS_FILE: {
-      size_t write_size = UTIL_MIN(file->file.data.capacity - file->file.data.offset, size);
-      void * res = memcpy(file->file.data.buffer + file->file.data.offset, buffer, write_size);
-      file->file.data.offset += write_size;
-      file->file.data.size += write_size;
-      return res == file->file.data.buffer + file->file.data.offset - write_size ? E_OK : E_FAILED;
+      size_t write_size = UTIL_MIN(node->file.data.capacity - file->offset, size);
+      void * res = memcpy(node->file.data.buffer + file->offset, buffer, write_size);
+      file->offset += write_size;
+      // Other descriptors may have already written past this offset
+      node->file.data.size = UTIL_MAX(node->file.data.size, file->offset);
+      return res == node->file.data.buffer + file->offset - write_size ? E_OK : E_FAILED;
     }
 
     case VFS_BLOCK: {
-      if (file->block.data.write) {
-        return file->block.data.write(file->block.data.ctx, file, buffer, size);
+      if (node->block.data.write) {
+        return node->block.data.write(node->block.data.ctx, file, buffer, size);
       }
       break;
     }
@@ -991,12 +1300,159 @@ error_t vfs_write(vfs_file_t * file, const uint8_t * buffer, size_t size) {
   return E_NOTIMPL;
 }
 
+error_t vfs_readv(vfs_file_t * file, const vfs_iovec_t * iov, size_t count, vfs_read_flags_t flags) {
+  ASSERT_RETURN(file && iov, E_NULL);
+
+  vfs_node_t * node = file->node;
+
+  if (node->head.type == VFS_BLOCK && node->block.data.readv) {
+    return node->block.data.readv(node->block.data.ctx, file, iov, count, flags);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    if (iov[i].size) {
+      ERROR_CHECK_RETURN(vfs_read(file, iov[i].base, iov[i].size, flags));
+    }
+  }
+
+  return E_OK;
+}
+
+error_t vfs_writev(vfs_file_t * file, const vfs_iovec_t * iov, size_t count) {
+  ASSERT_RETURN(file && iov, E_NULL);
+
+  vfs_node_t * node = file->node;
+
+  if (node->head.type == VFS_BLOCK && node->block.data.writev) {
+    return node->block.data.writev(node->block.data.ctx, file, iov, count);
+  }
+
+  for (size_t i = 0; i < count; ++i) {
+    if (iov[i].size) {
+      ERROR_CHECK_RETURN(vfs_write(file, iov[i].base, iov[i].size));
+    }
+  }
+
+  return E_OK;
+}
+
+error_t vfs_read_async(vfs_file_t * file, vfs_request_t * request) {
+  return vfs_request_submit(file, request, VFS_REQUEST_READ);
+}
+
+error_t vfs_write_async(vfs_file_t * file, vfs_request_t * request) {
+  return vfs_request_submit(file, request, VFS_REQUEST_WRITE);
+}
+
+error_t vfs_request_complete(vfs_request_t * request, error_t status) {
+  ASSERT_RETURN(request, E_NULL);
+  ASSERT_RETURN(request->state == VFS_REQUEST_STATE_PENDING, E_INVAL);
+
+  request->status = status;
+
+  // Waiter checks state and locks itself in the same critical section,
+  // so it can't miss the wake up
+  VFS_ATOMIC_BLOCK() {
+    request->file->pending--;
+    request->state = VFS_REQUEST_STATE_DONE;
+
+#if USE_VFS_OS
+    if (request->waiter) {
+      request->waiter->state = OS_TASK_STATE_READY;
+      request->waiter = NULL;
+    }
+#endif
+  }
+
+  if (request->done) {
+    request->done(request);
+  }
+
+  return E_OK;
+}
+
+bool vfs_request_is_done(vfs_request_t * request) {
+  ASSERT_RETURN(request, false);
+  return request->state == VFS_REQUEST_STATE_DONE;
+}
+
+error_t vfs_request_wait(vfs_request_t * request) {
+  ASSERT_RETURN(request, E_NULL);
+  ASSERT_RETURN(request->state != VFS_REQUEST_STATE_IDLE, E_INVAL);
+
+#if USE_VFS_OS
+  os_task_t * task = os_task_current();
+
+  while (task && request->state == VFS_REQUEST_STATE_PENDING) {
+    bool locked = false;
+
+    VFS_ATOMIC_BLOCK() {
+      if (request->state == VFS_REQUEST_STATE_PENDING) {
+        request->waiter = task;
+        task->state = OS_TASK_STATE_LOCKED;
+        locked = true;
+      }
+    }
+
+    if (locked) {
+      os_schedule();
+    }
+  }
+#endif
+
+  while (request->state == VFS_REQUEST_STATE_PENDING) {
+    VFS_REQUEST_WAIT();
+  }
+
+  return request->status;
+}
+
+error_t vfs_map(vfs_file_t * file, const uint8_t ** ptr, size_t * size) {
+  ASSERT_RETURN(file && ptr && size, E_NULL);
+
+  vfs_node_t * node = file->node;
+
+  switch (node->head.type) {
+    case VFS_FILE: {
+      *ptr = node->file.data.buffer;
+      *size = node->file.data.size;
+      return E_OK;
+    }
+
+    case VFS_BLOCK: {
+      return vfs_ioctl(file, VFS_IOCTL_MAP, ptr, size);
+    }
+
+    default:
+      break;
+  }
+
+  return E_NOTIMPL;
+}
+
+error_t vfs_read_ptr(vfs_file_t * file, size_t max, const uint8_t ** ptr, size_t * size) {
+  ASSERT_RETURN(file && ptr && size, E_NULL);
+
+  const uint8_t * data = NULL;
+  size_t data_size = 0;
+
+  ERROR_CHECK_RETURN(vfs_map(file, &data, &data_size));
+
+  file->offset = UTIL_MIN(file->offset, data_size);
+
+  *ptr = data + file->offset;
+  *size = UTIL_MIN(data_size - file->offset, max);
+  file->offset += *size;
+
+  return E_OK;
+}
+
 error_t vfs_seek(vfs_file_t * file, size_t offset) {
   ASSERT_RETURN(file, E_NULL);
 
-  switch (file->head.type) {
+  switch (file->node->head.type) {
     case VFS_FILE: {
-      file->file.data.offset = UTIL_MIN(offset, file->file.data.size);
+      file->offset = UTIL_MIN(offset, file->node->file.data.size);
       return E_OK;
     }
 
@@ -1014,9 +1470,9 @@ error_t vfs_seek(vfs_file_t * file, size_t offset) {
 size_t vfs_tell(vfs_file_t * file) {
   ASSERT_RETURN(file, 0);
 
-  switch (file->head.type) {
+  switch (file->node->head.type) {
     case VFS_FILE: {
-      return file->file.data.offset;
+      return file->offset;
     }
 
     case VFS_BLOCK: {
@@ -1046,10 +1502,12 @@ error_t vfs_ioctl(vfs_file_t * file, int cmd, ...) {
 error_t vfs_ioctl_va(vfs_file_t * file, int cmd, va_list args) {
   ASSERT_RETURN(file, E_NULL);
 
-  switch (file->head.type) {
+  vfs_node_t * node = file->node;
+
+  switch (node->head.type) {
     case VFS_BLOCK: {
-      if (file->block.data.ioctl) {
-        return file->block.data.ioctl(file->block.data.ctx, file, cmd, args);
+      if (node->block.data.ioctl) {
+        return node->block.data.ioctl(node->block.data.ctx, file, cmd, args);
       }
       break;
     }
@@ -16,6 +16,7 @@ extern "C" {
 /* Includes ================================================================= */
 #include "util/compiler.h"
 #include "table/table.h"
+#include "os/pool/pool.h"
 #include "error/error.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -31,7 +32,9 @@ extern "C" {
 
 /* Defines ================================================================== */
 /**
- * Max children a folder can have
+ * Max children a folder can have, when tables come from a table pool
+ * Dynamically allocated folder tables start with this capacity and grow
+ * on demand
  */
 #ifndef VFS_MAX_FOLDER_CHILDREN
 #define VFS_MAX_FOLDER_CHILDREN       4
@@ -59,6 +62,13 @@ extern "C" {
 #define VFS_MAX_PATH_DEPTH            4
 #endif
 
+/**
+ * Max files opened at the same time (size of descriptor pool in vfs_t)
+ */
+#ifndef VFS_MAX_OPEN_FILES
+#define VFS_MAX_OPEN_FILES            8
+#endif
+
 /**
  * If enabled, vfs will create and manage buffer for VFS_FILE dynamically
  * using VFS_ALLOC/VFS_FREE when creating VFS_FILE with buffer == NULL
@@ -95,6 +105,51 @@ extern "C" {
 #define VFS_PATH_SEP                  '/'
 #endif
 
+/**
+ * Path lookup cache size in entries (0 disables the cache)
+ *
+ * Remembers last resolved paths (and symlink targets), so vfs_open and
+ * friends don't walk the tree from root every time. Any create, remove
+ * or rename flushes the whole cache
+ */
+#ifndef VFS_DCACHE_SIZE
+#define VFS_DCACHE_SIZE               8
+#endif
+
+/**
+ * If enabled, vfs_request_wait called from OS task locks the task until
+ * vfs_request_complete wakes it, instead of polling request state
+ */
+#ifndef USE_VFS_OS
+#define USE_VFS_OS                    0
+#endif
+
+/**
+ * Called by vfs_request_wait on every poll of pending request, when it
+ * has no task to lock (USE_VFS_OS is 0, or it's called outside of task)
+ */
+#ifndef VFS_REQUEST_WAIT
+#define VFS_REQUEST_WAIT()
+#endif
+
+/**
+ * Critical section for request state and descriptor pending counter, as
+ * vfs_request_complete may be called from driver IRQ. Saves and restores
+ * IRQ mask, so it's fine to enter it from IRQ or with IRQs masked.
+ * Can be defined empty, if requests are completed only from tasks
+ */
+#ifndef VFS_ATOMIC_BLOCK
+#include "os/irq/irq.h"
+#define VFS_ATOMIC_BLOCK()                                        \
+    for (uint32_t __vfs_irq = os_irq_save(), __vfs_once = 1;      \
+         __vfs_once;                                              \
+         __vfs_once = 0, os_irq_restore(__vfs_irq))
+#endif
+
+#if USE_VFS_OS
+#include "os/os.h"
+#endif
+
 /**
  * Special value that can be passed to vfs_seek
  */
@@ -104,29 +159,24 @@ extern "C" {
 /**
  * Declares node pool for VFS instance
  *
- * Creates 2 variables - array (pool) with node containers and pool context
+ * Creates 2 variables - os_pool buffer and pool context (see OS_POOL_DEFINE)
  *
  * @param name Pool name. Variable for pool context will be named like this
- *             Array variable for array will be named name+_vfs_node_pool_nodes
  * @param size Size of pool in elements
  */
-#define VFS_DECLARE_NODE_POOL(__name, __size)                                       \
-  vfs_node_container_t UTIL_CAT(__name, _vfs_node_pool_nodes)[__size] = {0};        \
-  vfs_node_pool_t __name = {UTIL_CAT(__name, _vfs_node_pool_nodes), __size}
+#define VFS_DECLARE_NODE_POOL(__name, __size) \
+  OS_POOL_DEFINE(__name, sizeof(vfs_node_t), __size)
 
 /**
  * Declares table pool for VFS instance
  *
- * Creates 2 variables - array (pool) with table containers and pool context
+ * Creates 2 variables - os_pool buffer and pool context (see OS_POOL_DEFINE)
  *
  * @param name Pool name. Variable for pool context will be named like this
- *             Array variable for array will be named
- *             name+_vfs_table_pool_nodes
  * @param size Size of pool in elements
  */
-#define VFS_DECLARE_TABLE_POOL(__name, __size)                                      \
-  vfs_table_container_t UTIL_CAT(__name, _vfs_table_pool_nodes)[__size] = {0};      \
-  vfs_table_pool_t __name = {UTIL_CAT(__name, _vfs_table_pool_nodes), __size}
+#define VFS_DECLARE_TABLE_POOL(__name, __size) \
+  OS_POOL_DEFINE(__name, sizeof(vfs_table_container_t), __size)
 
 #define VFS_WITH(__vfs, __name, __path) \
   for (vfs_file_t * __name = vfs_open(__vfs, __path); __name; (vfs_close(__name), __name = NULL))
@@ -144,6 +194,14 @@ typedef enum {
   VFS_IOCTL_SEEK = 1,
   VFS_IOCTL_TELL = 2,
 
+  /**
+   * Zero-copy access to whole device contents, used by vfs_map and
+   * vfs_read_ptr. Args: const uint8_t ** ptr, size_t * size
+   *
+   * Memory may be read-only (e.g. flash), so it's never written through
+   */
+  VFS_IOCTL_MAP  = 3,
+
   VFS_IOCTL_RESERVED_128 = 128,
 
 #ifdef VFS_IOCTL_CMD_PORT
@@ -183,6 +241,16 @@ typedef enum {
   VFS_NODE_FLAG_OPENED      = 1 << 2,
 } vfs_node_flags_t;
 
+/**
+ * VFS File Descriptor Flags
+ */
+typedef enum {
+  VFS_FD_FLAG_NONE = 0,
+
+  /** Descriptor is taken from the pool */
+  VFS_FD_FLAG_USED = 1 << 0,
+} vfs_fd_flags_t;
+
 /**
  * VFS Read operation flags
  */
@@ -191,6 +259,23 @@ typedef enum {
   VFS_READ_FLAG_NOBLOCK = 1 << 0,
 } vfs_read_flags_t;
 
+/**
+ * VFS Asynchronous request type
+ */
+typedef enum {
+  VFS_REQUEST_READ = 0,
+  VFS_REQUEST_WRITE,
+} vfs_request_type_t;
+
+/**
+ * VFS Asynchronous request state
+ */
+typedef enum {
+  VFS_REQUEST_STATE_IDLE = 0,
+  VFS_REQUEST_STATE_PENDING,
+  VFS_REQUEST_STATE_DONE,
+} vfs_request_state_t;
+
 /* Types ==================================================================== */
 /**
  * Make alias node_type == file_type
@@ -208,9 +293,37 @@ typedef union vfs_node_t vfs_node_t;
 typedef struct vfs_s vfs_t;
 
 /**
- * Forward declaration of VFS File
+ * Forward declaration of VFS File Descriptor
+ */
+typedef struct vfs_fd_s vfs_fd_t;
+
+/**
+ * Opened file is a descriptor, not a node
  */
-typedef vfs_node_t vfs_file_t;
+typedef vfs_fd_t vfs_file_t;
+
+/**
+ * Forward declaration of VFS Asynchronous request
+ */
+typedef struct vfs_request_s vfs_request_t;
+
+/**
+ * VFS Asynchronous request completion callback
+ *
+ * @note May be called from interrupt context, if driver completes
+ *       requests from there
+ *
+ * @param request Completed request, status is already set
+ */
+typedef void (*vfs_request_done_fn_t)(vfs_request_t *);
+
+/**
+ * I/O vector segment for vfs_readv/vfs_writev
+ */
+typedef struct {
+  void * base;
+  size_t size;
+} vfs_iovec_t;
 
 /**
  * VFS Block File open() callback
@@ -258,6 +371,39 @@ typedef error_t (*vfs_block_write_fn_t)(void *, vfs_file_t *, const uint8_t *, s
  */
 typedef error_t (*vfs_block_ioctl_fn_t)(void *, vfs_file_t *, int, va_list);
 
+/**
+ * VFS Block File readv() callback (optional)
+ *
+ * @param ctx User context, passed to vfs_create_block
+ * @param file File, on which, the operation is performed
+ * @param iov Segments to read to, in order
+ * @param count Number of segments
+ * @param flags Read flags
+ */
+typedef error_t (*vfs_block_readv_fn_t)(void *, vfs_file_t *, const vfs_iovec_t *, size_t, vfs_read_flags_t);
+
+/**
+ * VFS Block File writev() callback (optional)
+ *
+ * @param ctx User context, passed to vfs_create_block
+ * @param file File, on which, the operation is performed
+ * @param iov Segments to write from, in order
+ * @param count Number of segments
+ */
+typedef error_t (*vfs_block_writev_fn_t)(void *, vfs_file_t *, const vfs_iovec_t *, size_t);
+
+/**
+ * VFS Block File submit() callback (optional)
+ *
+ * Starts asynchronous transfer (e.g. DMA) and returns right away. Driver
+ * may keep several requests in flight (chaining them through request->next)
+ * and must call vfs_request_complete for each one, when it's done
+ *
+ * @param ctx User context, passed to vfs_create_block
+ * @param request Request to start, request->file is the file
+ */
+typedef error_t (*vfs_block_submit_fn_t)(void *, vfs_request_t *);
+
 /**
  * VFS_FILE Node data
  */
@@ -265,7 +411,6 @@ typedef __PACKED_STRUCT {
   uint8_t * buffer;
   size_t    size;
   size_t    capacity;
-  size_t    offset;
   __PACKED_STRUCT {
     bool    allocated : 1;
   } flags;
@@ -275,12 +420,15 @@ typedef __PACKED_STRUCT {
  * VFS_BLOCK Node data
  */
 typedef __PACKED_STRUCT {
-  void *               ctx;
-  vfs_block_open_fn_t  open;
-  vfs_block_close_fn_t close;
-  vfs_block_read_fn_t  read;
-  vfs_block_write_fn_t write;
-  vfs_block_ioctl_fn_t ioctl;
+  void *                ctx;
+  vfs_block_open_fn_t   open;
+  vfs_block_close_fn_t  close;
+  vfs_block_read_fn_t   read;
+  vfs_block_write_fn_t  write;
+  vfs_block_ioctl_fn_t  ioctl;
+  vfs_block_readv_fn_t  readv;   /** If NULL, vfs_readv calls read for every segment */
+  vfs_block_writev_fn_t writev;  /** If NULL, vfs_writev calls write for every segment */
+  vfs_block_submit_fn_t submit;  /** If NULL, requests are done synchronously */
 } vfs_block_data_t;
 
 /**
@@ -365,37 +513,102 @@ typedef __PACKED_UNION vfs_node_t {
 } vfs_node_t;
 
 /**
- * VFS Node Container for node pool
+ * VFS Node Pool, elements are vfs_node_t
+ */
+typedef os_pool_t vfs_node_pool_t;
+
+/**
+ * VFS Table Container, element of table pool
  */
 typedef struct {
-  vfs_node_t node;
-  bool       used;
-} vfs_node_container_t;
+  table_t      table;
+  table_node_t nodes[VFS_MAX_FOLDER_CHILDREN];
+} vfs_table_container_t;
+
+/**
+ * VFS Table Pool, elements are vfs_table_container_t
+ */
+typedef os_pool_t vfs_table_pool_t;
 
 /**
- * VFS Node Pool
+ * VFS Node/Table allocation statistics
+ *
+ * Taken from os_pool statistics if pool is used, counted by VFS for
+ * dynamic allocation
  */
 typedef struct {
-  vfs_node_container_t * nodes;
-  size_t size;
-} vfs_node_pool_t;
+  size_t used;        /** Currently allocated */
+  size_t high_water;  /** Max allocated at once */
+  size_t exhausted;   /** Allocations failed because pool (or heap) was empty */
+} vfs_pool_stats_t;
 
 /**
- * VFS Table Container for table pool
+ * VFS allocation statistics
  */
 typedef struct {
-  table_t      table;
-  table_node_t nodes[VFS_MAX_FOLDER_CHILDREN];
-  bool         used;
-} vfs_table_container_t;
+  vfs_pool_stats_t nodes;
+  vfs_pool_stats_t tables;
+} vfs_stats_t;
+
+/**
+ * VFS File Descriptor
+ *
+ * Every vfs_open takes one from VFS descriptor pool, so each opener of a
+ * VFS_MULTI_OPEN file has its own read/write offset
+ */
+typedef struct vfs_fd_s {
+  vfs_t *      vfs;
+  vfs_node_t * node;
+  size_t       offset;
+  uint8_t      flags;   /** vfs_fd_flags_t */
+  uint8_t      pending; /** Submitted, but not yet completed requests */
+} vfs_fd_t;
+
+/**
+ * VFS Asynchronous request
+ *
+ * Owned by the caller and must stay valid until it's completed. buffer,
+ * size, done and ctx are set by the caller, the rest is filled by
+ * vfs_read_async/vfs_write_async
+ *
+ * @note Must be zero-initialized before first submit (e.g. with designated
+ *       initializer), state is checked to reject resubmitting a pending
+ *       request
+ */
+struct vfs_request_s {
+  void *                buffer;
+  size_t                size;
+  vfs_request_done_fn_t done;     /** Optional */
+  void *                ctx;      /** User context, not touched by VFS */
+
+  vfs_file_t *          file;
+  vfs_request_t *       next;     /** Free for driver to use while pending */
+  volatile error_t      status;
+  volatile uint8_t      state;    /** vfs_request_state_t */
+  uint8_t               type;     /** vfs_request_type_t */
+#if USE_VFS_OS
+  os_task_t *           waiter;   /** Task locked in vfs_request_wait */
+#endif
+};
 
 /**
- * VFS Table Pool
+ * VFS Path Lookup Cache Entry
  */
 typedef struct {
-  vfs_table_container_t * tables;
-  size_t size;
-} vfs_table_pool_t;
+  uint32_t     used;                /** LRU stamp, 0 if entry is free */
+  table_hash_t hash;                /** Hash of path */
+  vfs_node_t * node;                /** Node found by path */
+  vfs_node_t * target;              /** Resolved link target, NULL if not yet resolved */
+  char         path[VFS_MAX_PATH];
+} vfs_dcache_entry_t;
+
+/**
+ * VFS Path Lookup Cache Statistics
+ */
+typedef struct {
+  uint32_t hits;
+  uint32_t misses;
+} vfs_dcache_stats_t;
 
 /**
  * VFS Context
@@ -405,6 +618,18 @@ typedef struct vfs_s {
 
   vfs_node_pool_t *  node_pool;
   vfs_table_pool_t * table_pool;
+
+  vfs_fd_t           fds[VFS_MAX_OPEN_FILES];
+
+  vfs_stats_t        stats;       /** Dynamic allocation only, pools keep their own */
+
+#if VFS_DCACHE_SIZE
+  struct {
+    vfs_dcache_entry_t entries[VFS_DCACHE_SIZE];
+    uint32_t           tick;
+    vfs_dcache_stats_t stats;
+  } dcache;
+#endif
 } vfs_t;
 
 /**
@@ -508,12 +733,26 @@ size_t vfs_get_file_size(vfs_file_t * file);
 error_t vfs_set_multi_open_flag(vfs_file_t * file, bool flag);
 
 /**
- * Retrieves name (last token) from file
+ * Retrieves name (last token) from opened file
  *
  * @param file File to get name from
  */
 const char * vfs_get_file_name(vfs_file_t * file);
 
+/**
+ * Retrieves name (last token) from node
+ *
+ * @param node Node to get name from
+ */
+const char * vfs_get_node_name(vfs_node_t * node);
+
+/**
+ * Retrieves node behind opened file
+ *
+ * @param file Opened file context
+ */
+vfs_node_t * vfs_get_file_node(vfs_file_t * file);
+
 /**
  * Converts node type enum value to string
  *
@@ -545,6 +784,33 @@ error_t vfs_init(vfs_t * vfs, vfs_node_pool_t * node_pool, vfs_table_pool_t * ta
  */
 error_t vfs_deinit(vfs_t * vfs);
 
+/**
+ * Retrieves node/table allocation statistics
+ *
+ * @param vfs VFS Context
+ * @param stats Statistics. Result
+ */
+error_t vfs_get_stats(vfs_t * vfs, vfs_stats_t * stats);
+
+/**
+ * Drops all entries from path lookup cache
+ *
+ * @note VFS does this itself on create/remove/rename, call it only if
+ *       nodes were changed bypassing VFS API (e.g. symlink path edited)
+ *
+ * @param vfs VFS Context
+ */
+error_t vfs_dcache_flush(vfs_t * vfs);
+
+/**
+ * Retrieves path lookup cache hit/miss counters
+ *
+ * @param vfs VFS Context
+ * @param stats Counters. Result
+ * @retval E_NOTIMPL if cache is disabled (VFS_DCACHE_SIZE == 0)
+ */
+error_t vfs_dcache_get_stats(vfs_t * vfs, vfs_dcache_stats_t * stats);
+
 /**
  * Create blank file (node) at requested path
  *
@@ -635,7 +901,7 @@ error_t vfs_create_block(vfs_t * vfs, const char * path, const vfs_block_data_t
  * @param data File payload data
  * @param file File to use as context for newly created file
  */
-error_t vfs_create_block_static(vfs_t * vfs, const char * path, const vfs_block_data_t * data, vfs_file_t * file);
+error_t vfs_create_block_static(vfs_t * vfs, const char * path, const vfs_block_data_t * data, vfs_node_t * file);
 
 /**
  * Create symlink at requested path
@@ -658,7 +924,7 @@ error_t vfs_create_symlink(vfs_t * vfs, const char * path, const char * link);
  * @param link Link target
  * @param file File to use as context for newly created symlink
  */
-error_t vfs_create_symlink_static(vfs_t * vfs, const char * path, const char * link, vfs_file_t * file);
+error_t vfs_create_symlink_static(vfs_t * vfs, const char * path, const char * link, vfs_node_t * file);
 
 /**
  * Create hardlink at requested path
@@ -669,7 +935,7 @@ error_t vfs_create_symlink_static(vfs_t * vfs, const char * path, const char * l
  * @param path Path to hardlink
  * @param link_node Link target
  */
-error_t vfs_create_hardlink(vfs_t * vfs, const char * path, vfs_file_t * link_node);
+error_t vfs_create_hardlink(vfs_t * vfs, const char * path, vfs_node_t * link_node);
 
 /**
  * Statically create hardlink at requested path
@@ -681,13 +947,15 @@ error_t vfs_create_hardlink(vfs_t * vfs, const char * path, vfs_file_t * link_no
  * @param link_node Link target
  * @param file File to use as context for newly created hardlink
  */
-error_t vfs_create_hardlink_static(vfs_t * vfs, const char * path, vfs_file_t * link_node, vfs_file_t * file);
+error_t vfs_create_hardlink_static(vfs_t * vfs, const char * path, vfs_node_t * link_node, vfs_node_t * file);
 
 /**
  * Remove file/folder/etc. (node)
  *
  * @param vfs VFS Context
  * @param path Path to file
+ *
+ * @retval E_BUSY if node is still opened
  */
 error_t vfs_remove(vfs_t * vfs, const char * path);
 
@@ -699,6 +967,8 @@ error_t vfs_remove(vfs_t * vfs, const char * path);
  * @param vfs VFS Context
  * @param path Path to file
  * @param new_name New name
+ *
+ * @retval E_BUSY if node is still opened
  */
 error_t vfs_rename(vfs_t * vfs, const char * path, const char * new_name);
 
@@ -724,14 +994,17 @@ error_t vfs_mkdir(vfs_t * vfs, const char * path);
 /**
  * Opens file
  *
+ * Takes a descriptor from VFS descriptor pool, with offset set to 0
+ *
  * @param vfs VFS Context
  * @param path Path to file
- * @return NULL if failed, pointer to file if successful
+ * @return NULL if failed (or no free descriptors left), pointer to file
+ *         if successful
  */
 vfs_file_t * vfs_open(vfs_t * vfs, const char * path);
 
 /**
- * Closes opened file
+ * Closes opened file, returning its descriptor to the pool
  *
  * @param file File context
  */
@@ -756,6 +1029,118 @@ error_t vfs_read(vfs_file_t * file, uint8_t * buffer, size_t size, vfs_read_flag
  */
 error_t vfs_write(vfs_file_t * file, const uint8_t * buffer, size_t size);
 
+/**
+ * Scatter read from file
+ *
+ * Fills segments in order. Block devices get the whole vector through
+ * readv callback, if they implement it
+ *
+ * @param file Opened file context
+ * @param iov Segments to read to
+ * @param count Number of segments
+ * @param flags Read flags
+ */
+error_t vfs_readv(vfs_file_t * file, const vfs_iovec_t * iov, size_t count, vfs_read_flags_t flags);
+
+/**
+ * Gather write to file
+ *
+ * Writes segments in order, as if they were one buffer. Block devices get
+ * the whole vector through writev callback, if they implement it
+ *
+ * @param file Opened file context
+ * @param iov Segments to write from
+ * @param count Number of segments
+ */
+error_t vfs_writev(vfs_file_t * file, const vfs_iovec_t * iov, size_t count);
+
+/**
+ * Starts asynchronous read from file to request->buffer
+ *
+ * If file is not a block device, or it has no submit callback, request is
+ * done synchronously and is already completed on return. Otherwise,
+ * completion is signalled later through request->done and request state
+ *
+ * @note File can't be closed while it has pending requests
+ *
+ * @param file Opened file context
+ * @param request Request with buffer, size and (optionally) done set
+ * @retval E_OK if submitted, transfer result is in request->status
+ * @retval E_BUSY if request is already pending
+ */
+error_t vfs_read_async(vfs_file_t * file, vfs_request_t * request);
+
+/**
+ * Starts asynchronous write to file from request->buffer
+ *
+ * Same rules as vfs_read_async apply
+ *
+ * @param file Opened file context
+ * @param request Request with buffer, size and (optionally) done set
+ * @retval E_BUSY if request is already pending
+ */
+error_t vfs_write_async(vfs_file_t * file, vfs_request_t * request);
+
+/**
+ * Completes request, called by block driver
+ *
+ * Sets status, marks request as done and calls request->done
+ *
+ * @note Can be called from interrupt context
+ *
+ * @param request Pending request
+ * @param status Transfer result
+ */
+error_t vfs_request_complete(vfs_request_t * request, error_t status);
+
+/**
+ * Checks whether request is completed
+ *
+ * @param request Request
+ */
+bool vfs_request_is_done(vfs_request_t * request);
+
+/**
+ * Blocks until request is completed
+ *
+ * With USE_VFS_OS, current task is locked and woken up by
+ * vfs_request_complete, otherwise request is polled with VFS_REQUEST_WAIT
+ *
+ * @param request Submitted request
+ * @retval Request status
+ */
+error_t vfs_request_wait(vfs_request_t * request);
+
+/**
+ * Maps whole file contents, without copying
+ *
+ * Pointer is into file backing store (VFS_FILE buffer, or memory provided
+ * by block device through VFS_IOCTL_MAP) and stays valid while file is
+ * opened and not written past its capacity. Backing store may be
+ * read-only (e.g. flash), so data must not be modified through it
+ *
+ * @param file Opened file context
+ * @param ptr Pointer to file data. Result
+ * @param size File data size. Result
+ * @retval E_NOTIMPL if file can't be mapped (e.g. block device without
+ *         VFS_IOCTL_MAP)
+ */
+error_t vfs_map(vfs_file_t * file, const uint8_t ** ptr, size_t * size);
+
+/**
+ * Reads from file without copying
+ *
+ * Returns pointer to data at current offset and advances it, like vfs_read
+ * would. For block devices offset is descriptor's own, device isn't seeked
+ *
+ * @param file Opened file context
+ * @param max Max size to read
+ * @param ptr Pointer to data. Result
+ * @param size Size available at ptr, 0 at the end of file. Result
+ * @retval E_NOTIMPL if file can't be mapped
+ */
+error_t vfs_read_ptr(vfs_file_t * file, size_t max, const uint8_t ** ptr, size_t * size);
+
 /**
  * Set file read/write offset
  *
@@ -0,0 +1,423 @@
+/** ========================================================================= *
+ *
+ * @file heap_bench.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Heap backend benchmark
+ *
+ * Replays alloc/free traces against os_heap and reports throughput,
+ * per-operation latency percentiles, peak fragmentation and failure rate.
+ * Built once per backend (see CMakeLists.txt).
+ *
+ * Traces are either synthetic (modeled after typical firmware workloads),
+ * or recorded on target with trace_alloc (TRACE_ALLOC_USE_EVENTS) - raw
+ * trace_alloc_event_t streams, passed as arguments:
+ *   heap_bench_tlsf [trace.bin...]
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "os/heap/heap.h"
+#include "trace_alloc/trace_alloc.h"
+#include "log/log.h"
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Defines ================================================================== */
+#ifndef HEAP_BENCH_HEAP_SIZE
+#define HEAP_BENCH_HEAP_SIZE    (64 * 1024)
+#endif
+
+#define HEAP_BENCH_SLOTS        256
+#define HEAP_BENCH_OPS          200000
+#define HEAP_BENCH_MAP_SIZE     16384
+#define HEAP_BENCH_STATS_PERIOD 1000
+
+#if USE_OS_HEAP_TLSF
+#define HEAP_BENCH_BACKEND      "tlsf"
+#else
+#define HEAP_BENCH_BACKEND      "first-fit"
+#endif
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+/**
+ * Size class of a trace, picked with given probability (in %)
+ */
+typedef struct {
+  uint8_t probability;
+  size_t min;
+  size_t max;
+} heap_bench_size_class_t;
+
+/**
+ * Synthetic trace description
+ */
+typedef struct {
+  const char * name;
+  const heap_bench_size_class_t * classes;
+  size_t class_count;
+  uint8_t alloc_probability;  /** Probability of alloc vs free (in %) */
+  bool fifo;                  /** Free oldest allocation instead of random */
+} heap_bench_trace_t;
+
+/**
+ * Live allocation, recorded pointer (id) -> pointer in bench heap
+ */
+typedef struct {
+  uint32_t id;
+  void * ptr;
+} heap_bench_map_entry_t;
+
+/**
+ * Accumulated results
+ */
+typedef struct {
+  size_t allocs;
+  size_t frees;
+  size_t fails;
+  size_t peak_used;
+  uint8_t peak_fragmentation;
+  uint64_t total_ns;
+} heap_bench_result_t;
+
+/* Variables ================================================================ */
+static uint8_t heap_memory[HEAP_BENCH_HEAP_SIZE] __attribute__((aligned(16)));
+static heap_bench_map_entry_t map[HEAP_BENCH_MAP_SIZE];
+static uint32_t alloc_latency[HEAP_BENCH_OPS];
+static uint32_t free_latency[HEAP_BENCH_OPS];
+static uint32_t rng_state;
+
+/** Protocol messages - small, short lived, mostly freed in order */
+static const heap_bench_size_class_t trace_messages_classes[] = {
+  {70, 16,  64},
+  {30, 64,  256},
+};
+
+/** General purpose - mostly small, sometimes medium/big buffers */
+static const heap_bench_size_class_t trace_mixed_classes[] = {
+  {60, 8,    64},
+  {30, 64,   512},
+  {10, 512,  2048},
+};
+
+/** Driver buffers - big, long lived, interleaved with small churn */
+static const heap_bench_size_class_t trace_buffers_classes[] = {
+  {80, 8,    48},
+  {20, 1024, 4096},
+};
+
+static const heap_bench_trace_t traces[] = {
+  {"messages", trace_messages_classes, 2, 55, true},
+  {"mixed",    trace_mixed_classes,    3, 55, false},
+  {"buffers",  trace_buffers_classes,  2, 52, false},
+};
+
+/* Private functions ======================================================== */
+static uint32_t rng(void) {
+  rng_state ^= rng_state << 13;
+  rng_state ^= rng_state >> 17;
+  rng_state ^= rng_state << 5;
+  return rng_state;
+}
+
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+static size_t trace_pick_size(const heap_bench_trace_t * trace) {
+  uint32_t p = rng() % 100;
+
+  for (size_t i = 0; i < trace->class_count; ++i) {
+    if (p < trace->classes[i].probability) {
+      return trace->classes[i].min + rng() % (trace->classes[i].max - trace->classes[i].min + 1);
+    }
+    p -= trace->classes[i].probability;
+  }
+
+  return trace->classes[0].min;
+}
+
+/**
+ * Generates synthetic trace as trace_alloc events, slot index + 1 is used
+ * as pointer
+ */
+static size_t trace_generate(const heap_bench_trace_t * trace, trace_alloc_event_t * events, size_t count) {
+  bool used[HEAP_BENCH_SLOTS] = {0};
+  size_t head = 0, tail = 0, live = 0;
+
+  rng_state = 0x12345678;
+
+  for (size_t op = 0; op < count; ++op) {
+    bool alloc = live == 0 || (live < HEAP_BENCH_SLOTS && rng() % 100 < trace->alloc_probability);
+    size_t slot = trace->fifo ? (alloc ? head : tail) : rng() % HEAP_BENCH_SLOTS;
+
+    while (used[slot] == alloc) {
+      slot = (slot + 1) % HEAP_BENCH_SLOTS;
+    }
+
+    events[op].type = alloc ? TRACE_ALLOC_EVENT_ALLOC : TRACE_ALLOC_EVENT_FREE;
+    events[op].ptr = (uint32_t) slot + 1;
+    events[op].size = alloc ? (uint32_t) trace_pick_size(trace) : 0;
+    events[op].seq = (uint32_t) op;
+
+    used[slot] = alloc;
+
+    if (alloc) {
+      head = (slot + 1) % HEAP_BENCH_SLOTS;
+      live++;
+    } else {
+      tail = (slot + 1) % HEAP_BENCH_SLOTS;
+      live--;
+    }
+  }
+
+  return count;
+}
+
+static size_t map_slot(uint32_t id) {
+  size_t i = (id * 2654435761u) & (HEAP_BENCH_MAP_SIZE - 1);
+
+  while (map[i].ptr && map[i].id != id) {
+    i = (i + 1) & (HEAP_BENCH_MAP_SIZE - 1);
+  }
+
+  return i;
+}
+
+static void map_remove(size_t i) {
+  size_t j = i;
+
+  for (;;) {
+    j = (j + 1) & (HEAP_BENCH_MAP_SIZE - 1);
+
+    if (!map[j].ptr) {
+      break;
+    }
+
+    size_t k = (map[j].id * 2654435761u) & (HEAP_BENCH_MAP_SIZE - 1);
+
+    if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+      continue;
+    }
+
+    map[i] = map[j];
+    i = j;
+  }
+
+  map[i].ptr = NULL;
+}
+
+static int latency_cmp(const void * a, const void * b) {
+  uint32_t x = *(const uint32_t *) a;
+  uint32_t y = *(const uint32_t *) b;
+  return (x > y) - (x < y);
+}
+
+static uint32_t latency_percentile(uint32_t * samples, size_t count, size_t percent) {
+  return count ? samples[(count - 1) * percent / 100] : 0;
+}
+
+static void heap_sample(os_heap_t * heap, heap_bench_result_t * result) {
+  os_heap_stats_t stats;
+
+  if (os_heap_stats(heap, &stats) == E_OK && stats.fragmentation > result->peak_fragmentation) {
+    result->peak_fragmentation = stats.fragmentation;
+  }
+}
+
+/**
+ * Replays events, latency samples are left in alloc_latency/free_latency
+ */
+static void bench_replay(const trace_alloc_event_t * events, size_t count, heap_bench_result_t * result) {
+  os_heap_t heap;
+
+  memset(result, 0, sizeof(*result));
+  memset(map, 0, sizeof(map));
+
+  os_heap_create(&heap, heap_memory, sizeof(heap_memory));
+
+  for (size_t op = 0; op < count; ++op) {
+    const trace_alloc_event_t * event = &events[op];
+
+    switch (event->type) {
+      /* Dropped allocations weren't tracked on target, but did happen */
+      case TRACE_ALLOC_EVENT_ALLOC:
+      case TRACE_ALLOC_EVENT_DROP: {
+        size_t i = map_slot(event->ptr);
+
+        if (map[i].ptr || result->allocs >= HEAP_BENCH_OPS) {
+          break;
+        }
+
+        uint64_t start = now_ns();
+        void * ptr = os_heap_alloc(&heap, event->size);
+        uint64_t time = now_ns() - start;
+
+        alloc_latency[result->allocs++] = (uint32_t) time;
+        result->total_ns += time;
+
+        if (!ptr) {
+          result->fails++;
+          break;
+        }
+
+        memset(ptr, 0xA5, event->size);
+
+        map[i].id = event->ptr;
+        map[i].ptr = ptr;
+
+        if (heap.used > result->peak_used) {
+          result->peak_used = heap.used;
+        }
+        break;
+      }
+
+      case TRACE_ALLOC_EVENT_FREE:
+      case TRACE_ALLOC_EVENT_FREE_UNKNOWN: {
+        size_t i = map_slot(event->ptr);
+
+        /* Allocation failed here, or happened before recording started */
+        if (!map[i].ptr || result->frees >= HEAP_BENCH_OPS) {
+          break;
+        }
+
+        uint64_t start = now_ns();
+        os_heap_free(&heap, map[i].ptr);
+        uint64_t time = now_ns() - start;
+
+        free_latency[result->frees++] = (uint32_t) time;
+        result->total_ns += time;
+
+        map_remove(i);
+        break;
+      }
+
+      default:
+        break;
+    }
+
+    if (op % HEAP_BENCH_STATS_PERIOD == 0) {
+      heap_sample(&heap, result);
+    }
+  }
+
+  for (size_t i = 0; i < HEAP_BENCH_MAP_SIZE; ++i) {
+    if (map[i].ptr) {
+      os_heap_free(&heap, map[i].ptr);
+    }
+  }
+
+  if (heap.used) {
+    printf("WARNING: %zu bytes still used after freeing everything\n", heap.used);
+  }
+
+  os_heap_destroy(&heap);
+}
+
+static void bench_print_header(void) {
+  printf("%-12s %8s %6s %9s %7s %19s %19s %9s %5s\n",
+         "trace", "ops", "fail%", "Mops/s", "",
+         "alloc p50/p99/max", "free p50/p99/max", "peak", "frag");
+}
+
+static void bench_print(const char * name, heap_bench_result_t * result) {
+  size_t ops = result->allocs + result->frees;
+
+  qsort(alloc_latency, result->allocs, sizeof(uint32_t), latency_cmp);
+  qsort(free_latency, result->frees, sizeof(uint32_t), latency_cmp);
+
+  printf("%-12s %8zu %5.2f%% %9.2f %7s %5u/%5u/%7u %5u/%5u/%7u %9zu %4u%%\n",
+         name, ops,
+         result->allocs ? 100.0 * result->fails / result->allocs : 0.0,
+         result->total_ns ? ops * 1000.0 / result->total_ns : 0.0,
+         "ns:",
+         latency_percentile(alloc_latency, result->allocs, 50),
+         latency_percentile(alloc_latency, result->allocs, 99),
+         latency_percentile(alloc_latency, result->allocs, 100),
+         latency_percentile(free_latency, result->frees, 50),
+         latency_percentile(free_latency, result->frees, 99),
+         latency_percentile(free_latency, result->frees, 100),
+         result->peak_used, result->peak_fragmentation);
+}
+
+/**
+ * Loads recorded trace_alloc event stream
+ */
+static trace_alloc_event_t * trace_load(const char * path, size_t * count) {
+  FILE * file = fopen(path, "rb");
+
+  if (!file) {
+    printf("Can't open '%s'\n", path);
+    return NULL;
+  }
+
+  fseek(file, 0, SEEK_END);
+  long size = ftell(file);
+  fseek(file, 0, SEEK_SET);
+
+  trace_alloc_event_t * events = malloc(size > 0 ? (size_t) size : 1);
+
+  *count = events ? fread(events, sizeof(trace_alloc_event_t), (size_t) size / sizeof(trace_alloc_event_t), file) : 0;
+
+  fclose(file);
+
+  return events;
+}
+
+/* Shared functions ========================================================= */
+/**
+ * Log port, only errors are printed, so VFS-backed log isn't needed
+ */
+void log_fmt(const char * file, int line, log_level_t level, const char * tag, const char * fmt, ...) {
+  if (level < LOG_ERROR) {
+    return;
+  }
+
+  va_list args;
+  va_start(args, fmt);
+  printf("%s:%d: ", file, line);
+  vprintf(fmt, args);
+  printf("\n");
+  va_end(args);
+}
+
+int main(int argc, char ** argv) {
+  static trace_alloc_event_t events[HEAP_BENCH_OPS];
+  heap_bench_result_t result;
+
+  printf("Heap backend: %s, heap size: %u\n\n", HEAP_BENCH_BACKEND, HEAP_BENCH_HEAP_SIZE);
+
+  bench_print_header();
+
+  for (size_t i = 0; i < sizeof(traces) / sizeof(traces[0]); ++i) {
+    size_t count = trace_generate(&traces[i], events, HEAP_BENCH_OPS);
+
+    bench_replay(events, count, &result);
+    bench_print(traces[i].name, &result);
+  }
+
+  for (int i = 1; i < argc; ++i) {
+    size_t count = 0;
+    trace_alloc_event_t * recorded = trace_load(argv[i], &count);
+
+    if (!recorded) {
+      continue;
+    }
+
+    bench_replay(recorded, count, &result);
+    bench_print(argv[i], &result);
+
+    free(recorded);
+  }
+
+  return 0;
+}
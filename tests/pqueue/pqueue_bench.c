@@ -0,0 +1,124 @@
+/** ========================================================================= *
+ *
+ * @file pqueue_bench.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Priority queue vs linear scan benchmark
+ *
+ * Models a timer list: n periodic timers, every step takes the one with
+ * the earliest deadline and re-arms it with a random period. Additionally
+ * every 8th step cancels and re-arms a random timer, like a rescheduled
+ * timeout would. Linear scan keeps deadlines in a plain array and searches
+ * it for minimum on every step, the way existing subsystems do.
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "queue/pqueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+/* Defines ================================================================== */
+#define PQUEUE_BENCH_MAX_ITEMS  1024
+#define PQUEUE_BENCH_STEPS      1000000
+#define PQUEUE_BENCH_PERIOD     1000
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+typedef struct {
+  uint32_t deadline;
+  pqueue_node_t node;
+} pqueue_bench_timer_t;
+
+/* Variables ================================================================ */
+static pqueue_bench_timer_t timers[PQUEUE_BENCH_MAX_ITEMS];
+static pqueue_node_t * heap_buffer[PQUEUE_BENCH_MAX_ITEMS];
+static const size_t sizes[] = {4, 16, 64, 256, 1024};
+static volatile uint32_t bench_sink;
+
+/* Private functions ======================================================== */
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static uint32_t bench_period(void) {
+  return 1 + rand() % PQUEUE_BENCH_PERIOD;
+}
+
+static uint64_t bench_linear(size_t n) {
+  srand(n);
+
+  for (size_t i = 0; i < n; ++i) {
+    timers[i].deadline = bench_period();
+  }
+
+  uint64_t start = now_ns();
+
+  for (size_t step = 0; step < PQUEUE_BENCH_STEPS; ++step) {
+    size_t min = 0;
+
+    for (size_t i = 1; i < n; ++i) {
+      if (timers[i].deadline < timers[min].deadline) {
+        min = i;
+      }
+    }
+
+    uint32_t now = timers[min].deadline;
+    bench_sink = now;
+    timers[min].deadline = now + bench_period();
+
+    if (!(step & 7)) {
+      timers[rand() % n].deadline = now + bench_period();
+    }
+  }
+
+  return now_ns() - start;
+}
+
+static uint64_t bench_heap(size_t n) {
+  pqueue_t pq;
+
+  srand(n);
+  pqueue_init(&pq, heap_buffer, n);
+
+  for (size_t i = 0; i < n; ++i) {
+    pqueue_node_init(&timers[i].node);
+    pqueue_push(&pq, &timers[i].node, bench_period());
+  }
+
+  uint64_t start = now_ns();
+
+  for (size_t step = 0; step < PQUEUE_BENCH_STEPS; ++step) {
+    pqueue_node_t * node = pqueue_pop(&pq);
+
+    uint32_t now = node->key;
+    bench_sink = now;
+    pqueue_push(&pq, node, now + bench_period());
+
+    if (!(step & 7)) {
+      pqueue_update(&pq, &timers[rand() % n].node, now + bench_period());
+    }
+  }
+
+  return now_ns() - start;
+}
+
+/* Shared functions ========================================================= */
+int main(int argc, char ** argv) {
+  printf("%-8s %14s %14s %10s\n", "timers", "linear ns/op", "pqueue ns/op", "speedup");
+
+  for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+    double linear = (double) bench_linear(sizes[i]) / PQUEUE_BENCH_STEPS;
+    double heap = (double) bench_heap(sizes[i]) / PQUEUE_BENCH_STEPS;
+
+    printf("%-8zu %14.1f %14.1f %9.2fx\n", sizes[i], linear, heap, linear / heap);
+  }
+
+  return 0;
+}
@@ -0,0 +1,245 @@
+/** ========================================================================= *
+ *
+ * @file pqueue_tests.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Priority queue tests
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "test/test.h"
+#include "queue/pqueue.h"
+#include <stdio.h>
+#include <stdlib.h>
+
+/* Defines ================================================================== */
+#define PQUEUE_TEST_ITEMS 64
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+typedef struct {
+  int id;
+  pqueue_node_t node;
+} pqueue_test_item_t;
+
+/* Variables ================================================================ */
+/* Private functions ======================================================== */
+static void items_init(pqueue_test_item_t * items, size_t count) {
+  for (size_t i = 0; i < count; ++i) {
+    items[i].id = (int) i;
+    pqueue_node_init(&items[i].node);
+  }
+}
+
+/**
+ * Pops everything, checking that keys are non-decreasing
+ */
+static bool pqueue_drain_sorted(pqueue_t * pq, size_t expected) {
+  size_t count = 0;
+  uint32_t last = 0;
+  pqueue_node_t * node;
+
+  while ((node = pqueue_pop(pq))) {
+    if (count && node->key < last) {
+      return false;
+    }
+    if (node->index != PQUEUE_INDEX_NONE) {
+      return false;
+    }
+    last = node->key;
+    count++;
+  }
+
+  return count == expected;
+}
+
+TEST_SUITE_DECLARE(PQUEUE, 16);
+
+TEST_DECLARE(PQUEUE, empty) {
+  PQUEUE_DEFINE(pq, 4);
+
+  TEST_ASSERT_EQ(pqueue_size(&pq), 0, "queue is not empty");
+  TEST_ASSERT_EQ(pqueue_peek(&pq), NULL, "peek on empty returned node");
+  TEST_ASSERT_EQ(pqueue_pop(&pq), NULL, "pop on empty returned node");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, push_pop_order) {
+  PQUEUE_DEFINE(pq, PQUEUE_TEST_ITEMS);
+  pqueue_test_item_t items[PQUEUE_TEST_ITEMS];
+
+  items_init(items, PQUEUE_TEST_ITEMS);
+  srand(42);
+
+  for (size_t i = 0; i < PQUEUE_TEST_ITEMS; ++i) {
+    TEST_ASSERT_ERROR(pqueue_push(&pq, &items[i].node, rand() % 100), "pqueue_push failed");
+  }
+
+  TEST_ASSERT_EQ(pqueue_size(&pq), PQUEUE_TEST_ITEMS, "wrong size");
+  TEST_ASSERT(pqueue_drain_sorted(&pq, PQUEUE_TEST_ITEMS), "pop order is wrong");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, peek) {
+  PQUEUE_DEFINE(pq, 4);
+  pqueue_test_item_t items[3];
+
+  items_init(items, 3);
+
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[0].node, 30), "pqueue_push failed");
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[1].node, 10), "pqueue_push failed");
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[2].node, 20), "pqueue_push failed");
+
+  pqueue_node_t * node = pqueue_peek(&pq);
+
+  TEST_ASSERT_NEQ(node, NULL, "peek returned NULL");
+  TEST_ASSERT_EQ(PQUEUE_ENTRY(node, pqueue_test_item_t, node)->id, 1, "wrong item on top");
+  TEST_ASSERT_EQ(pqueue_size(&pq), 3, "peek changed size");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, overflow_and_inuse) {
+  PQUEUE_DEFINE(pq, 2);
+  pqueue_test_item_t items[3];
+
+  items_init(items, 3);
+
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[0].node, 1), "pqueue_push failed");
+  TEST_ASSERT_EQ(pqueue_push(&pq, &items[0].node, 1), E_INUSE, "double push not detected");
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[1].node, 2), "pqueue_push failed");
+  TEST_ASSERT_EQ(pqueue_push(&pq, &items[2].node, 3), E_OVERFLOW, "overflow not detected");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, update) {
+  PQUEUE_DEFINE(pq, PQUEUE_TEST_ITEMS);
+  pqueue_test_item_t items[PQUEUE_TEST_ITEMS];
+
+  items_init(items, PQUEUE_TEST_ITEMS);
+
+  for (size_t i = 0; i < PQUEUE_TEST_ITEMS; ++i) {
+    TEST_ASSERT_ERROR(pqueue_push(&pq, &items[i].node, 1000 + i), "pqueue_push failed");
+  }
+
+  TEST_ASSERT_ERROR(pqueue_update(&pq, &items[40].node, 5), "decrease key failed");
+  TEST_ASSERT_EQ(pqueue_peek(&pq), &items[40].node, "decreased node is not on top");
+
+  TEST_ASSERT_ERROR(pqueue_update(&pq, &items[40].node, 5000), "increase key failed");
+  TEST_ASSERT_EQ(pqueue_peek(&pq), &items[0].node, "wrong node on top after increase");
+
+  TEST_ASSERT(pqueue_drain_sorted(&pq, PQUEUE_TEST_ITEMS), "pop order is wrong");
+  TEST_ASSERT_EQ(pqueue_update(&pq, &items[0].node, 1), E_NOTFOUND, "update of popped node");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, remove) {
+  PQUEUE_DEFINE(pq, PQUEUE_TEST_ITEMS);
+  pqueue_test_item_t items[PQUEUE_TEST_ITEMS];
+
+  items_init(items, PQUEUE_TEST_ITEMS);
+  srand(7);
+
+  for (size_t i = 0; i < PQUEUE_TEST_ITEMS; ++i) {
+    TEST_ASSERT_ERROR(pqueue_push(&pq, &items[i].node, rand() % 1000), "pqueue_push failed");
+  }
+
+  size_t removed = 0;
+
+  for (size_t i = 0; i < PQUEUE_TEST_ITEMS; i += 3) {
+    TEST_ASSERT_ERROR(pqueue_remove(&pq, &items[i].node), "pqueue_remove failed");
+    TEST_ASSERT(!pqueue_contains(&pq, &items[i].node), "removed node is still queued");
+    removed++;
+  }
+
+  TEST_ASSERT_EQ(pqueue_remove(&pq, &items[0].node), E_NOTFOUND, "double remove not detected");
+  TEST_ASSERT(pqueue_drain_sorted(&pq, PQUEUE_TEST_ITEMS - removed), "pop order is wrong");
+
+  TEST_ASSERT_ERROR(pqueue_push(&pq, &items[0].node, 1), "push after remove failed");
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, randomized) {
+  PQUEUE_DEFINE(pq, PQUEUE_TEST_ITEMS);
+  pqueue_test_item_t items[PQUEUE_TEST_ITEMS];
+
+  items_init(items, PQUEUE_TEST_ITEMS);
+  srand(1234);
+
+  for (size_t op = 0; op < 20000; ++op) {
+    pqueue_test_item_t * item = &items[rand() % PQUEUE_TEST_ITEMS];
+    bool queued = pqueue_contains(&pq, &item->node);
+
+    switch (rand() % 4) {
+      case 0:
+        if (!queued) {
+          TEST_ASSERT_ERROR(pqueue_push(&pq, &item->node, rand() % 500), "pqueue_push failed");
+        }
+        break;
+
+      case 1:
+        if (queued) {
+          TEST_ASSERT_ERROR(pqueue_update(&pq, &item->node, rand() % 500), "pqueue_update failed");
+        }
+        break;
+
+      case 2:
+        if (queued) {
+          TEST_ASSERT_ERROR(pqueue_remove(&pq, &item->node), "pqueue_remove failed");
+        }
+        break;
+
+      case 3: {
+        pqueue_node_t * top = pqueue_pop(&pq);
+
+        for (size_t i = 0; top && i < pq.size; ++i) {
+          TEST_ASSERT(top->key <= pq.nodes[i]->key, "popped node is not minimal");
+        }
+        break;
+      }
+    }
+
+    for (size_t i = 1; i < pq.size; ++i) {
+      TEST_ASSERT(pq.nodes[(i - 1) / 2]->key <= pq.nodes[i]->key, "heap property broken");
+      TEST_ASSERT_EQ(pq.nodes[i]->index, i, "node index is stale");
+    }
+  }
+
+  return true;
+}
+
+TEST_DECLARE(PQUEUE, clear) {
+  PQUEUE_DEFINE(pq, 4);
+  pqueue_test_item_t items[4];
+
+  items_init(items, 4);
+
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_ERROR(pqueue_push(&pq, &items[i].node, i), "pqueue_push failed");
+  }
+
+  TEST_ASSERT_ERROR(pqueue_clear(&pq), "pqueue_clear failed");
+  TEST_ASSERT_EQ(pqueue_size(&pq), 0, "queue is not empty");
+
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_EQ(items[i].node.index, PQUEUE_INDEX_NONE, "node is still marked queued");
+  }
+
+  return true;
+}
+
+/* Shared functions ========================================================= */
+int main(int argc, char ** argv) {
+  TEST_LOG_PORT(ANSI_TEXT_BOLD "===================[ PQUEUE ]==================\n" ANSI_TEXT_RESET);
+
+  return tests_run(&PQUEUE, argc, argv);
+}
@@ -0,0 +1,114 @@
+/** ========================================================================= *
+ *
+ * @file table_bench.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Hash table benchmark
+ *
+ * Fills a table with string keys up to given load factor and measures
+ * insert, lookup (hit and miss), churn (remove + insert of a different
+ * key, which leaves tombstones) and remove, in ns per operation.
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "table/table.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+/* Defines ================================================================== */
+#define TABLE_BENCH_CAP     1024
+#define TABLE_BENCH_KEYS    (2 * TABLE_BENCH_CAP)
+#define TABLE_BENCH_ROUNDS  200
+#define TABLE_BENCH_KEY_LEN 16
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+typedef struct {
+  char name[TABLE_BENCH_KEY_LEN];
+} table_bench_item_t;
+
+/* Variables ================================================================ */
+static table_bench_item_t items[TABLE_BENCH_KEYS];
+static table_node_t nodes[TABLE_BENCH_CAP];
+static const size_t loads[] = {25, 50, 75, 90, 95};
+static volatile void * bench_sink;
+
+/* Private functions ======================================================== */
+static uint64_t now_ns(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000000ull + ts.tv_nsec;
+}
+
+static bool item_match(const void * value, const void * key) {
+  return !strcmp(((const table_bench_item_t *) value)->name, key);
+}
+
+static void bench_load(size_t load) {
+  size_t n = TABLE_BENCH_CAP * load / 100;
+  uint64_t insert = 0, hit = 0, miss = 0, churn = 0, remove = 0;
+  table_t table;
+
+  table_init(&table, nodes, TABLE_BENCH_CAP);
+  table_set_key_match(&table, item_match);
+
+  for (size_t round = 0; round < TABLE_BENCH_ROUNDS; ++round) {
+    uint64_t start = now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      table_add_str(&table, items[i].name, &items[i]);
+    }
+    insert += now_ns() - start;
+
+    start = now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      bench_sink = table_find_str(&table, items[i].name);
+    }
+    hit += now_ns() - start;
+
+    start = now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      bench_sink = table_find_str(&table, items[TABLE_BENCH_CAP + i].name);
+    }
+    miss += now_ns() - start;
+
+    // Replace every second key with one, that wasn't in the table
+    start = now_ns();
+    for (size_t i = 0; i < n; i += 2) {
+      table_remove_str(&table, items[i].name);
+      table_add_str(&table, items[TABLE_BENCH_CAP + i].name, &items[TABLE_BENCH_CAP + i]);
+    }
+    churn += now_ns() - start;
+
+    start = now_ns();
+    for (size_t i = 0; i < n; ++i) {
+      table_remove_str(&table, items[i & 1 ? i : TABLE_BENCH_CAP + i].name);
+    }
+    remove += now_ns() - start;
+  }
+
+  double ops = (double) n * TABLE_BENCH_ROUNDS;
+
+  printf("%3zu%% %10.1f %10.1f %10.1f %10.1f %10.1f\n", load,
+    insert / ops, hit / ops, miss / ops, churn / (ops / 2), remove / ops);
+}
+
+/* Shared functions ========================================================= */
+int main(int argc, char ** argv) {
+  for (size_t i = 0; i < TABLE_BENCH_KEYS; ++i) {
+    snprintf(items[i].name, TABLE_BENCH_KEY_LEN, "node%zu", i);
+  }
+
+  printf("capacity %d, ns/op\n", TABLE_BENCH_CAP);
+  printf("load %10s %10s %10s %10s %10s\n", "insert", "hit", "miss", "churn", "remove");
+
+  for (size_t i = 0; i < UTIL_ARR_SIZE(loads); ++i) {
+    bench_load(loads[i]);
+  }
+
+  return 0;
+}
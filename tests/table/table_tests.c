@@ -0,0 +1,183 @@
+/** ========================================================================= *
+ *
+ * @file table_tests.c
+ * @date 18-10-2026
+ * @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+ *
+ * @brief Hash table tests
+ *
+ *  ========================================================================= */
+
+/* Includes ================================================================= */
+#include "test/test.h"
+#include "table/table.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Defines ================================================================== */
+#define TABLE_TEST_CAP 16
+
+/* Macros =================================================================== */
+/* Exposed macros =========================================================== */
+/* Enums ==================================================================== */
+/* Types ==================================================================== */
+typedef struct {
+  const char * name;
+} table_test_item_t;
+
+/* Variables ================================================================ */
+static table_test_item_t items[] = {
+  {"alpha"}, {"beta"}, {"gamma"}, {"delta"}, {"epsilon"}, {"zeta"},
+  {"eta"}, {"theta"}, {"iota"}, {"kappa"}, {"lambda"}, {"mu"},
+};
+
+/* Private functions ======================================================== */
+static bool item_match(const void * value, const void * key) {
+  return !strcmp(((const table_test_item_t *) value)->name, key);
+}
+
+TEST_SUITE_DECLARE(TABLE, 16);
+
+TEST_DECLARE(TABLE, add_find) {
+  TABLE_DEFINE(table, TABLE_TEST_CAP);
+  table_set_key_match(&table, item_match);
+
+  for (size_t i = 0; i < UTIL_ARR_SIZE(items); ++i) {
+    TEST_ASSERT_ERROR(table_add_str(&table, items[i].name, &items[i]), "table_add_str failed");
+  }
+
+  TEST_ASSERT_EQ(table_get_size(&table), UTIL_ARR_SIZE(items), "wrong size");
+
+  for (size_t i = 0; i < UTIL_ARR_SIZE(items); ++i) {
+    TEST_ASSERT_EQ(table_find_str(&table, items[i].name), &items[i], "wrong value found");
+  }
+
+  TEST_ASSERT_EQ(table_find_str(&table, "omega"), NULL, "found missing key");
+  TEST_ASSERT_EQ(table_add_str(&table, "beta", &items[0]), E_INUSE, "duplicate not detected");
+
+  return true;
+}
+
+TEST_DECLARE(TABLE, collisions) {
+  TABLE_DEFINE(table, TABLE_TEST_CAP);
+  table_set_key_match(&table, item_match);
+
+  // Same hash for every key - all go into one probe chain
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_ERROR(table_add_key(&table, 42, items[i].name, &items[i]), "table_add_key failed");
+  }
+
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_EQ(table_find_key(&table, 42, items[i].name), &items[i], "colliding keys alias");
+  }
+
+  TEST_ASSERT_ERROR(table_remove_key(&table, 42, items[1].name), "table_remove_key failed");
+
+  TEST_ASSERT_EQ(table_find_key(&table, 42, items[1].name), NULL, "removed key found");
+  TEST_ASSERT_EQ(table_find_key(&table, 42, items[2].name), &items[2], "probe chain broken by remove");
+  TEST_ASSERT_EQ(table_find_key(&table, 42, items[3].name), &items[3], "probe chain broken by remove");
+
+  return true;
+}
+
+TEST_DECLARE(TABLE, wrap_around) {
+  TABLE_DEFINE(table, 4);
+
+  // Chain starting at last node has to continue from node 0
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_ERROR(table_add(&table, 3 + 4 * i, &items[i]), "table_add failed");
+  }
+
+  TEST_ASSERT_EQ(table_add(&table, 7 + 16, &items[4]), E_NOMEM, "full table not detected");
+
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_EQ(table_find(&table, 3 + 4 * i), &items[i], "value not found");
+  }
+
+  TEST_ASSERT_EQ(table_find(&table, 7 + 16), NULL, "found missing key in full table");
+
+  return true;
+}
+
+TEST_DECLARE(TABLE, tombstones) {
+  TABLE_DEFINE(table, 8);
+
+  for (size_t i = 0; i < 4; ++i) {
+    TEST_ASSERT_ERROR(table_add(&table, 1 + 8 * i, &items[i]), "table_add failed");
+  }
+
+  TEST_ASSERT_ERROR(table_remove(&table, 1), "table_remove failed");
+  TEST_ASSERT_EQ(table.tombstones, 1, "tombstone not left");
+  TEST_ASSERT_EQ(table_find(&table, 25), &items[3], "probe chain broken by remove");
+
+  TEST_ASSERT_ERROR(table_add(&table, 33, &items[4]), "table_add failed");
+  TEST_ASSERT_EQ(table.tombstones, 0, "tombstone not reused");
+  TEST_ASSERT_EQ(table_find(&table, 33), &items[4], "value not found");
+
+  // Removing chain tail turns trailing tombstones back into empty nodes
+  TEST_ASSERT_ERROR(table_remove(&table, 9), "table_remove failed");
+  TEST_ASSERT_ERROR(table_remove(&table, 17), "table_remove failed");
+  TEST_ASSERT_EQ(table.tombstones, 2, "wrong tombstone count");
+  TEST_ASSERT_ERROR(table_remove(&table, 25), "table_remove failed");
+  TEST_ASSERT_EQ(table.tombstones, 0, "trailing tombstones not cleared");
+  TEST_ASSERT_EQ(table_find(&table, 33), &items[4], "value not found");
+
+  return true;
+}
+
+TEST_DECLARE(TABLE, resize) {
+  TABLE_DEFINE(table, 4);
+  table_node_t bigger[16];
+
+  table_set_key_match(&table, item_match);
+
+  for (size_t i = 0; i < 3; ++i) {
+    TEST_ASSERT_ERROR(table_add_str(&table, items[i].name, &items[i]), "table_add_str failed");
+  }
+
+  TEST_ASSERT(table_should_grow(&table), "table_should_grow is false at 100%");
+  TEST_ASSERT_ERROR(table_remove_str(&table, items[0].name), "table_remove_str failed");
+  TEST_ASSERT_ERROR(table_resize(&table, bigger, UTIL_ARR_SIZE(bigger)), "table_resize failed");
+  TEST_ASSERT_EQ(table.tombstones, 0, "tombstones survived resize");
+
+  for (size_t i = 3; i < UTIL_ARR_SIZE(items); ++i) {
+    TEST_ASSERT_ERROR(table_add_str(&table, items[i].name, &items[i]), "table_add_str failed");
+  }
+
+  for (size_t i = 1; i < UTIL_ARR_SIZE(items); ++i) {
+    TEST_ASSERT_EQ(table_find_str(&table, items[i].name), &items[i], "value lost on resize");
+  }
+
+  TEST_ASSERT_EQ(table_resize(&table, table_table_buf, 4), E_INVAL, "shrink below size allowed");
+
+  return true;
+}
+
+TEST_DECLARE(TABLE, iterate) {
+  TABLE_DEFINE(table, TABLE_TEST_CAP);
+  table_set_key_match(&table, item_match);
+
+  for (size_t i = 0; i < UTIL_ARR_SIZE(items); ++i) {
+    TEST_ASSERT_ERROR(table_add_str(&table, items[i].name, &items[i]), "table_add_str failed");
+  }
+
+  size_t count = 0;
+  table_test_item_t * item = NULL;
+
+  TABLE_FOREACH(&table, iter, item) {
+    TEST_ASSERT_ERROR(table_remove_str(&table, item->name), "remove while iterating failed");
+    count++;
+  }
+
+  TEST_ASSERT_EQ(count, UTIL_ARR_SIZE(items), "not all values visited");
+  TEST_ASSERT_EQ(table_get_size(&table), 0, "table is not empty");
+
+  return true;
+}
+
+/* Shared functions ========================================================= */
+int main(int argc, char ** argv) {
+  TEST_LOG_PORT(ANSI_TEXT_BOLD "===================[ TABLE ]===================\n" ANSI_TEXT_RESET);
+
+  return tests_run(&TABLE, argc, argv);
+}
@@ -41,7 +41,6 @@ TEST_DECLARE(VFS, sizeof) {
     "sizeof(vfs_node_hardlink_t)    %lu\n"
     "\n"
     "sizeof(vfs_node_pool_t)        %lu\n"
-    "sizeof(vfs_node_container_t)   %lu\n"
     "sizeof(vfs_table_pool_t)       %lu\n"
     "sizeof(vfs_table_container_t)  %lu\n"
     "\n"
@@ -57,7 +56,6 @@ TEST_DECLARE(VFS, sizeof) {
     sizeof(vfs_node_symlink_t),
     sizeof(vfs_node_hardlink_t),
     sizeof(vfs_node_pool_t),
-    sizeof(vfs_node_container_t),
     sizeof(vfs_table_pool_t),
     sizeof(vfs_table_container_t),
     sizeof(table_t),
@@ -280,7 +278,7 @@ TEST_DECLARE(VFS, vfs_create_file) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/test", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_node_t * test_file = vfs_find_node(&vfs, "/test");
@@ -439,7 +437,7 @@ TEST_DECLARE(VFS, vfs_mkdir) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/test/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_node_t * node = vfs_find_node(&vfs, "/dev/console/test/0");
@@ -467,7 +465,7 @@ TEST_DECLARE(VFS, vfs_dynamic) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_node_t * node = vfs_find_node(&vfs, "/dev/console/0");
@@ -497,6 +495,42 @@ TEST_DECLARE(VFS, vfs_dynamic) {
   return true;
 }
 
+TEST_DECLARE(VFS, vfs_pool) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 3);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  TEST_ASSERT_ERROR(vfs_create_folder(&vfs, "/a"), "vfs_create_folder failed");
+  TEST_ASSERT_ERROR(vfs_create_folder(&vfs, "/b"), "vfs_create_folder failed");
+  TEST_ASSERT_ERROR(vfs_create(&vfs, "/c", VFS_FILE), "vfs_create failed");
+  TEST_ASSERT_EQ(vfs_create(&vfs, "/d", VFS_FILE), E_NOMEM, "node pool exhaustion not detected");
+
+  vfs_node_t * b = vfs_find_node(&vfs, "/b");
+
+  // Freed container is the first one handed out again
+  TEST_ASSERT_ERROR(vfs_remove(&vfs, "/b"), "vfs_remove failed");
+  TEST_ASSERT_ERROR(vfs_create(&vfs, "/d", VFS_FILE), "vfs_create failed");
+  TEST_ASSERT_EQ(vfs_find_node(&vfs, "/d"), b, "freed node not reused");
+  TEST_ASSERT_EQ(vfs_find_node(&vfs, "/d")->head.flags & VFS_NODE_FLAG_OPENED, 0, "stale node flags");
+
+  vfs_stats_t stats;
+  TEST_ASSERT_ERROR(vfs_get_stats(&vfs, &stats), "vfs_get_stats failed");
+
+  TEST_LOG("nodes: used %zu high %zu exhausted %zu, tables: used %zu high %zu exhausted %zu\n",
+    stats.nodes.used, stats.nodes.high_water, stats.nodes.exhausted,
+    stats.tables.used, stats.tables.high_water, stats.tables.exhausted);
+
+  TEST_ASSERT_EQ(stats.nodes.used, 3, "wrong used node count");
+  TEST_ASSERT_EQ(stats.nodes.high_water, 3, "wrong node high water");
+  TEST_ASSERT_EQ(stats.nodes.exhausted, 1, "wrong node exhaustion count");
+  TEST_ASSERT_EQ(stats.tables.used, 2, "wrong used table count");
+  TEST_ASSERT_EQ(stats.tables.high_water, 3, "wrong table high water");
+
+  return true;
+}
+
 TEST_DECLARE(VFS, vfs_open) {
   vfs_t vfs;
   VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
@@ -515,7 +549,7 @@ TEST_DECLARE(VFS, vfs_open) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
 
@@ -526,6 +560,49 @@ TEST_DECLARE(VFS, vfs_open) {
   return true;
 }
 
+#if VFS_DCACHE_SIZE
+TEST_DECLARE(VFS, vfs_dcache) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  TEST_ASSERT_ERROR(vfs_create_folder(&vfs, "/dev"), "vfs_create_folder failed");
+  TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/null", &(vfs_file_data_t){NULL, 0}), "vfs_create_file failed");
+  TEST_ASSERT_ERROR(vfs_create_symlink(&vfs, "/null", "/dev/null"), "vfs_create_symlink failed");
+
+  vfs_node_t * target = vfs_find_node(&vfs, "/dev/null");
+  TEST_ASSERT_NEQ(target, NULL, "target is NULL");
+
+  vfs_dcache_stats_t before;
+  vfs_dcache_stats_t after;
+  TEST_ASSERT_ERROR(vfs_dcache_flush(&vfs), "vfs_dcache_flush failed");
+  TEST_ASSERT_ERROR(vfs_dcache_get_stats(&vfs, &before), "vfs_dcache_get_stats failed");
+
+  // First open walks link and its target, second one takes both from cache
+  vfs_file_t * file = vfs_open(&vfs, "/null");
+  TEST_ASSERT_EQ(vfs_get_file_node(file), target, "symlink resolved to wrong node");
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  file = vfs_open(&vfs, "/null");
+  TEST_ASSERT_EQ(vfs_get_file_node(file), target, "cached symlink resolved to wrong node");
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  TEST_ASSERT_ERROR(vfs_dcache_get_stats(&vfs, &after), "vfs_dcache_get_stats failed");
+  TEST_LOG("hits %u misses %u\n", after.hits - before.hits, after.misses - before.misses);
+  TEST_ASSERT_EQ(after.hits - before.hits, 1, "wrong hit count");
+  TEST_ASSERT_EQ(after.misses - before.misses, 2, "wrong miss count");
+
+  // Removing the target must not leave a stale cached link target behind
+  TEST_ASSERT_ERROR(vfs_remove(&vfs, "/dev/null"), "vfs_remove failed");
+  TEST_ASSERT_EQ(vfs_find_node(&vfs, "/dev/null"), NULL, "removed node found");
+  TEST_ASSERT_EQ(vfs_open(&vfs, "/null"), NULL, "dangling symlink opened");
+
+  return true;
+}
+#endif
+
 TEST_DECLARE(VFS, vfs_read) {
   vfs_t vfs;
   VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
@@ -544,7 +621,7 @@ TEST_DECLARE(VFS, vfs_read) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
 
@@ -581,7 +658,7 @@ TEST_DECLARE(VFS, vfs_write) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_file_t * file = vfs_open(&vfs, "/dev/console/0");
@@ -592,7 +669,7 @@ TEST_DECLARE(VFS, vfs_write) {
 
   TEST_ASSERT_ERROR(vfs_write(file, write_buf, sizeof(write_buf)), "vfs_write failed");
 
-  file->file.data.offset = 0;
+  file->offset = 0;
 
   uint8_t read_buf[4] = {0};
 
@@ -623,7 +700,7 @@ TEST_DECLARE(VFS, vfs_seek) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_file_t * file = vfs_open(&vfs, "/dev/console/0");
@@ -661,7 +738,7 @@ TEST_DECLARE(VFS, vfs_tell) {
   };
 
   TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/dev/console/0", &(vfs_file_data_t){
-    test_file_data, sizeof(test_file_data), sizeof(test_file_data), 0
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
   }), "vfs_create_file failed");
 
   vfs_file_t * file = vfs_open(&vfs, "/dev/console/0");
@@ -677,6 +754,96 @@ TEST_DECLARE(VFS, vfs_tell) {
   return true;
 }
 
+TEST_DECLARE(VFS, vfs_multi_open) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  uint8_t test_file_data[8] = {0, 1, 2, 3, 4, 5, 6, 7};
+
+  TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/test", &(vfs_file_data_t){
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
+  }), "vfs_create_file failed");
+
+  vfs_file_t * first = vfs_open(&vfs, "/test");
+  TEST_ASSERT_NEQ(first, NULL, "first is NULL");
+  TEST_ASSERT_EQ(vfs_open(&vfs, "/test"), NULL, "opened twice without multi open flag");
+
+  TEST_ASSERT_ERROR(vfs_set_multi_open_flag(first, true), "vfs_set_multi_open_flag failed");
+
+  vfs_file_t * second = vfs_open(&vfs, "/test");
+  TEST_ASSERT_NEQ(second, NULL, "second is NULL");
+  TEST_ASSERT_NEQ(first, second, "same descriptor returned twice");
+
+  uint8_t buf[2] = {0};
+
+  // Each descriptor streams from its own offset
+  TEST_ASSERT_ERROR(vfs_read(first, buf, sizeof(buf), VFS_READ_FLAG_NONE), "vfs_read failed");
+  TEST_ASSERT_ERROR(vfs_read(first, buf, sizeof(buf), VFS_READ_FLAG_NONE), "vfs_read failed");
+  TEST_ASSERT_EQ(buf[0], 2, "wrong data read from first");
+  TEST_ASSERT_EQ(vfs_tell(first), 4, "wrong first offset");
+
+  TEST_ASSERT_ERROR(vfs_read(second, buf, sizeof(buf), VFS_READ_FLAG_NONE), "vfs_read failed");
+  TEST_ASSERT_EQ(buf[0], 0, "wrong data read from second");
+  TEST_ASSERT_EQ(vfs_tell(second), 2, "wrong second offset");
+
+  TEST_ASSERT_ERROR(vfs_close(second), "vfs_close failed");
+  TEST_ASSERT_EQ(vfs_tell(first), 4, "first offset changed by close of second");
+
+  TEST_ASSERT_EQ(vfs_remove(&vfs, "/test"), E_BUSY, "removed opened file");
+  TEST_ASSERT_EQ(vfs_rename(&vfs, "/test", "other"), E_BUSY, "renamed opened file");
+
+  TEST_ASSERT_ERROR(vfs_close(first), "vfs_close failed");
+
+  TEST_ASSERT_EQ(vfs_get_file_node(first)->head.flags & VFS_NODE_FLAG_OPENED, 0, "node still opened");
+
+  return true;
+}
+
+TEST_DECLARE(VFS, vfs_map) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  uint8_t test_file_data[6] = {0, 1, 2, 3, 4, 5};
+
+  TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/test", &(vfs_file_data_t){
+    test_file_data, sizeof(test_file_data), sizeof(test_file_data)
+  }), "vfs_create_file failed");
+
+  vfs_file_t * file = vfs_open(&vfs, "/test");
+  TEST_ASSERT_NEQ(file, NULL, "file is NULL");
+
+  const uint8_t * data = NULL;
+  size_t size = 0;
+
+  TEST_ASSERT_ERROR(vfs_map(file, &data, &size), "vfs_map failed");
+  TEST_ASSERT_EQ(data, test_file_data, "mapped pointer is not file buffer");
+  TEST_ASSERT_EQ(size, sizeof(test_file_data), "wrong mapped size");
+
+  const uint8_t * ptr = NULL;
+
+  TEST_ASSERT_ERROR(vfs_read_ptr(file, 4, &ptr, &size), "vfs_read_ptr failed");
+  TEST_ASSERT_EQ(ptr, test_file_data, "wrong pointer");
+  TEST_ASSERT_EQ(size, 4, "wrong size");
+
+  TEST_ASSERT_ERROR(vfs_read_ptr(file, 4, &ptr, &size), "vfs_read_ptr failed");
+  TEST_ASSERT_EQ(ptr, test_file_data + 4, "wrong pointer");
+  TEST_ASSERT_EQ(size, 2, "read past end of file");
+
+  TEST_ASSERT_ERROR(vfs_read_ptr(file, 4, &ptr, &size), "vfs_read_ptr failed");
+  TEST_ASSERT_EQ(size, 0, "read past end of file");
+  TEST_ASSERT_EQ(vfs_tell(file), sizeof(test_file_data), "wrong offset");
+
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  return true;
+}
+
 struct {
   bool block_open_called;
   bool block_close_called;
@@ -769,6 +936,153 @@ TEST_DECLARE(VFS, vfs_block) {
   return true;
 }
 
+static size_t block_writev_count;
+
+error_t block_writev(void * ctx, vfs_file_t * file, const vfs_iovec_t * iov, size_t count) {
+  block_writev_count = count;
+
+  return E_OK;
+}
+
+TEST_DECLARE(VFS, vfs_iovec) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  uint8_t test_file_data[8] = {0};
+
+  TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/test", &(vfs_file_data_t){
+    test_file_data, 0, sizeof(test_file_data)
+  }), "vfs_create_file failed");
+
+  TEST_ASSERT_ERROR(vfs_create_block(&vfs, "/block", &(vfs_block_data_t){
+    .write = block_write, .writev = block_writev
+  }), "vfs_create_block failed");
+
+  vfs_file_t * file = vfs_open(&vfs, "/test");
+  TEST_ASSERT_NEQ(file, NULL, "file is NULL");
+
+  uint8_t head[3] = {1, 2, 3};
+  uint8_t tail[2] = {4, 5};
+
+  // File has no writev - segments are written one by one
+  TEST_ASSERT_ERROR(vfs_writev(file, (vfs_iovec_t[]){
+    {head, sizeof(head)}, {NULL, 0}, {tail, sizeof(tail)}
+  }, 3), "vfs_writev failed");
+  TEST_ASSERT_EQ(vfs_tell(file), 5, "wrong offset");
+
+  uint8_t first[2] = {0};
+  uint8_t second[3] = {0};
+
+  TEST_ASSERT_ERROR(vfs_seek(file, 0), "vfs_seek failed");
+  TEST_ASSERT_ERROR(vfs_readv(file, (vfs_iovec_t[]){
+    {first, sizeof(first)}, {second, sizeof(second)}
+  }, 2, VFS_READ_FLAG_NONE), "vfs_readv failed");
+
+  TEST_ASSERT(!memcmp(first, (uint8_t[]){1, 2}, sizeof(first)), "wrong first segment");
+  TEST_ASSERT(!memcmp(second, (uint8_t[]){3, 4, 5}, sizeof(second)), "wrong second segment");
+
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  file = vfs_open(&vfs, "/block");
+  TEST_ASSERT_NEQ(file, NULL, "file is NULL");
+
+  block_writev_count = 0;
+
+  TEST_ASSERT_ERROR(vfs_writev(file, (vfs_iovec_t[]){
+    {head, sizeof(head)}, {tail, sizeof(tail)}
+  }, 2), "vfs_writev failed");
+  TEST_ASSERT_EQ(block_writev_count, 2, "writev wasn't passed through");
+
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  return true;
+}
+
+static vfs_request_t * block_queue;
+static size_t block_done_count;
+
+error_t block_submit(void * ctx, vfs_request_t * request) {
+  request->next = block_queue;
+  block_queue = request;
+
+  return E_OK;
+}
+
+void block_request_done(vfs_request_t * request) {
+  block_done_count++;
+}
+
+TEST_DECLARE(VFS, vfs_async) {
+  vfs_t vfs;
+  VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
+  VFS_DECLARE_TABLE_POOL(vfs_table_pool, 4);
+
+  TEST_ASSERT_ERROR(vfs_init(&vfs, &vfs_node_pool, &vfs_table_pool), "vfs_init failed");
+
+  uint8_t test_file_data[4] = {0};
+
+  TEST_ASSERT_ERROR(vfs_create_file(&vfs, "/test", &(vfs_file_data_t){
+    test_file_data, 0, sizeof(test_file_data)
+  }), "vfs_create_file failed");
+
+  TEST_ASSERT_ERROR(vfs_create_block(&vfs, "/block", &(vfs_block_data_t){
+    .submit = block_submit
+  }), "vfs_create_block failed");
+
+  // Regular file - request is completed before vfs_write_async returns
+  vfs_file_t * file = vfs_open(&vfs, "/test");
+  TEST_ASSERT_NEQ(file, NULL, "file is NULL");
+
+  uint8_t data[4] = {1, 2, 3, 4};
+  vfs_request_t sync = {.buffer = data, .size = sizeof(data), .done = block_request_done};
+
+  block_done_count = 0;
+
+  TEST_ASSERT_ERROR(vfs_write_async(file, &sync), "vfs_write_async failed");
+  TEST_ASSERT(vfs_request_is_done(&sync), "request is not done");
+  TEST_ASSERT_EQ(block_done_count, 1, "done wasn't called");
+  TEST_ASSERT_ERROR(vfs_request_wait(&sync), "request failed");
+  TEST_ASSERT(!memcmp(test_file_data, data, sizeof(data)), "data wasn't written");
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  // Block device - requests stay pending until driver completes them
+  file = vfs_open(&vfs, "/block");
+  TEST_ASSERT_NEQ(file, NULL, "file is NULL");
+
+  vfs_request_t first = {.buffer = data, .size = 2, .done = block_request_done};
+  vfs_request_t second = {.buffer = data + 2, .size = 2};
+
+  block_queue = NULL;
+  block_done_count = 0;
+
+  TEST_ASSERT_ERROR(vfs_read_async(file, &first), "vfs_read_async failed");
+  TEST_ASSERT_ERROR(vfs_write_async(file, &second), "vfs_write_async failed");
+  TEST_ASSERT_EQ(vfs_read_async(file, &first), E_BUSY, "pending request resubmitted");
+
+  TEST_ASSERT_EQ(block_queue, &second, "request wasn't submitted");
+  TEST_ASSERT_EQ(second.next, &first, "request wasn't submitted");
+  TEST_ASSERT_EQ(first.type, VFS_REQUEST_READ, "wrong request type");
+  TEST_ASSERT_EQ(second.type, VFS_REQUEST_WRITE, "wrong request type");
+  TEST_ASSERT(!vfs_request_is_done(&first), "request done before completion");
+  TEST_ASSERT_EQ(vfs_close(file), E_BUSY, "file closed with pending requests");
+
+  TEST_ASSERT_ERROR(vfs_request_complete(&second, E_IO), "vfs_request_complete failed");
+  TEST_ASSERT_EQ(vfs_request_wait(&second), E_IO, "wrong request status");
+  TEST_ASSERT_EQ(block_done_count, 0, "wrong done called");
+
+  TEST_ASSERT_ERROR(vfs_request_complete(&first, E_OK), "vfs_request_complete failed");
+  TEST_ASSERT_ERROR(vfs_request_wait(&first), "wrong request status");
+  TEST_ASSERT_EQ(block_done_count, 1, "done wasn't called");
+  TEST_ASSERT_EQ(vfs_request_complete(&first, E_OK), E_INVAL, "request completed twice");
+
+  TEST_ASSERT_ERROR(vfs_close(file), "vfs_close failed");
+
+  return true;
+}
+
 TEST_DECLARE(VFS, vfs_dynamic_file) {
   vfs_t vfs;
   VFS_DECLARE_NODE_POOL(vfs_node_pool, 4);
@@ -263,3 +263,29 @@ macro(project_add_link_options target)
         __add_link_options(${ARGV})
     endif ()
 endmacro()
+
+#
+# @brief Generates perfect hash index of shell commands, declared with
+#        SHELL_DECLARE_COMMAND in project sources, and adds it to the project
+#
+# Makes shell command lookup one hash + one strcmp, instead of comparing
+# against every command. Without it shell uses linear search.
+#
+# @note Call after all sources were added, before project_finish
+#
+macro(project_add_shell_command_index)
+    find_package(Python3 REQUIRED COMPONENTS Interpreter)
+
+    set(shell_cmd_index_src "${CMAKE_BINARY_DIR}/shell_cmd_index.c")
+    set(shell_cmd_index_tool "${SDK_DIR}/toolchain/scripts/shell_cmd_index.py")
+
+    add_custom_command(
+        OUTPUT ${shell_cmd_index_src}
+        COMMAND ${Python3_EXECUTABLE} ${shell_cmd_index_tool} -o ${shell_cmd_index_src} ${PROJECT_SOURCES}
+        DEPENDS ${shell_cmd_index_tool} ${PROJECT_SOURCES}
+        COMMENT "Generating shell command index"
+        VERBATIM
+    )
+
+    list(APPEND PROJECT_SOURCES ${shell_cmd_index_src})
+endmacro()
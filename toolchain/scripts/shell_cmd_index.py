@@ -0,0 +1,132 @@
+#!/usr/bin/env python3
+# =========================================================================
+#
+# @file shell_cmd_index.py
+# @date 18-10-2026
+# @author Maksym Tkachuk <max.r.tkachuk@gmail.com>
+#
+# @brief Generates perfect hash index of shell commands
+#
+# Collects command names from SHELL_DECLARE_COMMAND in given sources and
+# emits a C file with shell_command_index (see shell_command_index_t).
+# Commands are referenced through weak symbols, so commands compiled out
+# by preprocessor conditions are just NULL slots.
+#
+# Usage: shell_cmd_index.py -o shell_cmd_index.c source.c...
+#
+# =========================================================================
+
+import argparse
+import re
+import sys
+
+FNV_OFFSET = 2166136261
+FNV_PRIME = 16777619
+MASK32 = 0xFFFFFFFF
+MAX_SEED = 0xFFFF
+
+DECLARE_RE = re.compile(r'^\s*SHELL_DECLARE_COMMAND\s*\(\s*([A-Za-z_]\w*)\s*,', re.MULTILINE)
+
+
+def command_hash(name: str, seed: int) -> int:
+    """Must match shell_command_hash in lib/shell/shell.c"""
+    h = (FNV_OFFSET ^ seed) & MASK32
+    for c in name.encode():
+        h ^= c
+        h = (h * FNV_PRIME) & MASK32
+    return h ^ (h >> 16)
+
+
+def collect_commands(sources):
+    names = set()
+    for source in sources:
+        with open(source, encoding='utf-8', errors='replace') as f:
+            names.update(DECLARE_RE.findall(f.read()))
+    return sorted(names)
+
+
+def build_index(names):
+    """Hash and displace: names are split into buckets by hash with seed 0,
+    then every bucket (biggest first) gets a seed, that puts all its names
+    into free distinct slots"""
+    size = len(names)
+    bucket_count = max(1, (size + 1) // 2)
+
+    buckets = [[] for _ in range(bucket_count)]
+    for name in names:
+        buckets[command_hash(name, 0) % bucket_count].append(name)
+
+    seeds = [0] * bucket_count
+    slots = [None] * size
+
+    for bucket in sorted(range(bucket_count), key=lambda b: -len(buckets[b])):
+        if not buckets[bucket]:
+            continue
+
+        for seed in range(1, MAX_SEED + 1):
+            placed = [command_hash(name, seed) % size for name in buckets[bucket]]
+            if len(set(placed)) == len(placed) and all(slots[i] is None for i in placed):
+                break
+        else:
+            sys.exit(f'shell_cmd_index: no seed found for bucket {bucket}')
+
+        seeds[bucket] = seed
+        for name, slot in zip(buckets[bucket], placed):
+            slots[slot] = name
+
+    return seeds, slots
+
+
+def generate(names):
+    lines = [
+        '/* Generated by shell_cmd_index.py, do not edit */',
+        '#include "shell/shell.h"',
+        '',
+    ]
+
+    if not names:
+        lines.append('const shell_command_index_t shell_command_index = {NULL, NULL, 0, 0};')
+        return '\n'.join(lines) + '\n'
+
+    seeds, slots = build_index(names)
+
+    for name in names:
+        lines.append(f'extern const shell_command_t {name}_shell_command __WEAK;')
+
+    lines += [
+        '',
+        f'static const uint16_t shell_command_index_seeds[{len(seeds)}] = {{',
+        '  ' + ', '.join(str(s) for s in seeds) + ',',
+        '};',
+        '',
+        f'static const shell_command_t * const shell_command_index_commands[{len(slots)}] = {{',
+    ]
+    lines += [f'  &{name}_shell_command,' for name in slots]
+    lines += [
+        '};',
+        '',
+        'const shell_command_index_t shell_command_index = {',
+        '  shell_command_index_seeds,',
+        '  shell_command_index_commands,',
+        f'  {len(seeds)},',
+        f'  {len(slots)},',
+        '};',
+    ]
+
+    return '\n'.join(lines) + '\n'
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Generate shell command perfect hash index')
+    parser.add_argument('-o', '--output', required=True, help='Output C file')
+    parser.add_argument('sources', nargs='*', help='Sources to scan for SHELL_DECLARE_COMMAND')
+    args = parser.parse_args()
+
+    content = generate(collect_commands(args.sources))
+
+    with open(args.output, 'w', encoding='utf-8') as f:
+        f.write(content)
+
+
+if __name__ == '__main__':
+    main()